@@ -0,0 +1,310 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "pd_api.h"
+#include "bayer.h"
+#include "dither.h"
+#include "renderer.h"
+
+typedef enum {
+    FORMAT_CSV,
+    FORMAT_JSON,
+} OutputFormat;
+
+typedef struct {
+    const char* benchmark;
+    const char* engine;
+    const char* size;
+    const char* orientation;
+    int bayer;
+    double nsPerOp;
+    double pixelsPerOp;
+    int isTriangle;
+} Result;
+
+typedef struct {
+    const char* name;
+    Vector3 points[3];  // Inside the unit square, scaled to the triangle size
+} Shape;
+
+typedef struct {
+    const char* name;
+    float width;
+    float height;
+} Size;
+
+typedef struct {
+    const char* name;
+    float dx;
+    float dy;
+} Direction;
+
+typedef struct {
+    uint8_t* frame;
+    Triangle triangle;
+    const DitherPattern* pattern;
+    FillEngine engine;
+    int x1, y1, x2, y2;
+    Matrix4x4 a, b, c;
+    Vector3 in, out;
+} Context;
+
+static const Shape shapes[] = {
+        {"flat_bottom", {{0.5f, 0.0f, 0.0f}, {1.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f}}},
+        {"flat_top",    {{0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.5f, 1.0f, 0.0f}}},
+        {"middle_left", {{1.0f, 0.0f, 0.0f}, {0.0f, 0.4f, 0.0f}, {0.8f, 1.0f, 0.0f}}},
+        {"middle_right", {{0.0f, 0.0f, 0.0f}, {1.0f, 0.6f, 0.0f}, {0.2f, 1.0f, 0.0f}}},
+        {"sliver",      {{0.0f, 0.0f, 0.0f}, {1.0f, 0.9f, 0.0f}, {0.9f, 1.0f, 0.0f}}},
+};
+
+// Bounding boxes of the triangles, the flat triangles of the quarter size cover a quarter of the screen
+static const Size sizes[] = {
+        {"tiny",    6.0f,   6.0f},
+        {"quarter", 283.0f, 170.0f},
+        {"full",    400.0f, 240.0f},
+};
+
+static const Direction directions[] = {
+        {"horizontal", 1.0f, 0.0f},
+        {"vertical",   0.0f, 1.0f},
+        {"diagonal",   1.0f, 1.0f},
+        {"shallow",    1.0f, 0.25f},
+        {"steep",      0.25f, 1.0f},
+};
+
+static const Size lineLengths[] = {
+        {"short",   8.0f,   8.0f},
+        {"quarter", 100.0f, 100.0f},
+        {"full",    400.0f, 240.0f},
+};
+
+static const int bayerSizes[] = {BAYER_2, BAYER_4, BAYER_8};
+
+static double minSeconds = 0.1;
+
+static double now_seconds(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double) time.tv_sec + (double) time.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Runs a kernel in growing batches until minSeconds have passed and returns the nanoseconds per call.
+ */
+
+static double measure(void (* kernel)(Context*), Context* context) {
+    kernel(context);
+
+    long iterations = 0;
+    long batch = 1;
+    double start = now_seconds();
+    double elapsed;
+
+    do {
+        for (long i = 0; i < batch; i++)
+            kernel(context);
+
+        iterations += batch;
+        batch *= 2;
+        elapsed = now_seconds() - start;
+    } while (elapsed < minSeconds);
+
+    return elapsed * 1e9 / (double) iterations;
+}
+
+static void run_matrix_multiply(Context* context) {
+    matrix4x4_multiply(&context->a, &context->b, &context->c);
+    context->a.m[3][0] = context->c.m[3][0] * 1e-9f;
+}
+
+static void run_vector_multiply(Context* context) {
+    vector3_multiply_matrix4x4(&context->in, &context->out, &context->a);
+    context->in.x = context->out.x * 1e-9f + 0.5f;
+}
+
+static void run_triangle_normal(Context* context) {
+    Vector3 normal = triangle_normal(&context->triangle);
+    context->triangle.points[0].z = normal.z * 1e-9f;
+}
+
+static void run_fill(Context* context) {
+    if (context->engine == FILL_ENGINE_HALF_SPACE) {
+        renderer_draw_fill(
+                context->frame,
+                (int) context->triangle.points[0].x, (int) context->triangle.points[0].y,
+                (int) context->triangle.points[1].x, (int) context->triangle.points[1].y,
+                (int) context->triangle.points[2].x, (int) context->triangle.points[2].y,
+                LCD_COLUMNS, LCD_ROWS,
+                context->pattern
+        );
+    } else {
+        renderer_draw_fill_by_triangle(context->frame, context->triangle, LCD_COLUMNS, LCD_ROWS, context->pattern, context->engine);
+    }
+}
+
+static void run_line(Context* context) {
+    renderer_draw_line(context->frame, context->x1, context->y1, context->x2, context->y2, LCD_COLUMNS, LCD_ROWS, kColorBlack);
+}
+
+/**
+ * @brief Counts the pixels one fill changes, by drawing a solid black triangle into a white frame.
+ */
+
+static int count_fill_pixels(Context* context, const DitherTable* table) {
+    DitherPattern black = dither_pattern(table, 0.0f);
+    const DitherPattern* pattern = context->pattern;
+
+    memset(context->frame, 0xFF, LCD_ROWS * LCD_ROWSIZE);
+    context->pattern = &black;
+    run_fill(context);
+    context->pattern = pattern;
+
+    int pixels = 0;
+    for (int row = 0; row < LCD_ROWS; row++)
+        for (int column = 0; column < LCD_COLUMNS; column++)
+            pixels += !(context->frame[row * LCD_ROWSIZE + column / 8] & (0x80 >> (column & 7)));
+
+    return pixels;
+}
+
+static Triangle shape_triangle(const Shape* shape, const Size* size) {
+    // Centered on the screen
+    float left = ((float) LCD_COLUMNS - size->width) * 0.5f;
+    float top = ((float) LCD_ROWS - size->height) * 0.5f;
+
+    Triangle triangle;
+    for (int p = 0; p < 3; p++) {
+        triangle.points[p].x = left + shape->points[p].x * size->width;
+        triangle.points[p].y = top + shape->points[p].y * size->height;
+        triangle.points[p].z = 0.0f;
+    }
+    return triangle;
+}
+
+static void print_result(OutputFormat format, const Result* result, int first) {
+    double pixelsPerSecond = result->pixelsPerOp * 1e9 / result->nsPerOp;
+    double trianglesPerSecond = result->isTriangle ? 1e9 / result->nsPerOp : 0.0;
+
+    if (format == FORMAT_CSV) {
+        printf("%s,%s,%s,%s,%d,%.3f,%.0f,%.0f,%.0f\n",
+               result->benchmark, result->engine, result->size, result->orientation, result->bayer,
+               result->nsPerOp, result->pixelsPerOp, pixelsPerSecond, trianglesPerSecond);
+        return;
+    }
+
+    printf("%s\n    {\"benchmark\": \"%s\", \"engine\": \"%s\", \"size\": \"%s\", \"orientation\": \"%s\", \"bayer\": %d, "
+           "\"ns_per_op\": %.3f, \"pixels_per_op\": %.0f, \"pixels_per_s\": %.0f, \"triangles_per_s\": %.0f}",
+           first ? "" : ",",
+           result->benchmark, result->engine, result->size, result->orientation, result->bayer,
+           result->nsPerOp, result->pixelsPerOp, pixelsPerSecond, trianglesPerSecond);
+}
+
+static void print_usage(const char* name) {
+    printf("usage: %s [--format csv|json] [--min-time seconds]\n", name);
+}
+
+int main(int argc, char** argv) {
+    OutputFormat format = FORMAT_CSV;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            const char* value = argv[++i];
+            format = strcmp(value, "json") == 0 ? FORMAT_JSON : FORMAT_CSV;
+        } else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            minSeconds = atof(argv[++i]);
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    Context context = {.frame = malloc(LCD_ROWS * LCD_ROWSIZE)};
+    memset(context.frame, 0xFF, LCD_ROWS * LCD_ROWSIZE);
+
+    if (format == FORMAT_CSV)
+        printf("benchmark,engine,size,orientation,bayer,ns_per_op,pixels_per_op,pixels_per_s,triangles_per_s\n");
+    else
+        printf("{\n  \"results\": [");
+
+    int first = 1;
+
+    // Math
+    context.a = matrix4X4_projection(60, (float) LCD_COLUMNS / (float) LCD_ROWS, 0.1f, 100.0f);
+    matrix4x4_rotate_y(&context.a, 0.5f, &context.b);
+    context.in = (Vector3) {0.5f, 0.25f, 2.0f};
+    context.triangle = shape_triangle(&shapes[2], &sizes[1]);
+
+    Result math[] = {
+            {"matrix4x4_multiply",         "", "", "", 0, measure(run_matrix_multiply, &context), 0, 0},
+            {"vector3_multiply_matrix4x4", "", "", "", 0, measure(run_vector_multiply, &context), 0, 0},
+            {"triangle_normal",            "", "", "", 0, measure(run_triangle_normal, &context), 0, 0},
+    };
+
+    for (int i = 0; i < (int) (sizeof(math) / sizeof(math[0])); i++, first = 0)
+        print_result(format, &math[i], first);
+
+    // Fills
+    const FillEngine engines[] = {FILL_ENGINE_HALF_SPACE, FILL_ENGINE_SCANLINE};
+    const char* engineNames[] = {"half_space", "scanline"};
+
+    for (int b = 0; b < (int) (sizeof(bayerSizes) / sizeof(bayerSizes[0])); b++) {
+        DitherTable* table = dither_create_bayer(bayerSizes[b]);
+        DitherPattern pattern = dither_pattern(table, 0.5f);
+        context.pattern = &pattern;
+
+        for (int e = 0; e < 2; e++) {
+            context.engine = engines[e];
+
+            for (int s = 0; s < (int) (sizeof(sizes) / sizeof(sizes[0])); s++) {
+                for (int o = 0; o < (int) (sizeof(shapes) / sizeof(shapes[0])); o++, first = 0) {
+                    context.triangle = shape_triangle(&shapes[o], &sizes[s]);
+
+                    int pixels = count_fill_pixels(&context, table);
+                    Result result = {
+                            "renderer_draw_fill", engineNames[e], sizes[s].name, shapes[o].name, bayerSizes[b],
+                            measure(run_fill, &context), pixels, 1
+                    };
+                    print_result(format, &result, first);
+                }
+            }
+        }
+
+        dither_destroy(table);
+    }
+
+    // Lines
+    for (int l = 0; l < (int) (sizeof(lineLengths) / sizeof(lineLengths[0])); l++) {
+        for (int d = 0; d < (int) (sizeof(directions) / sizeof(directions[0])); d++, first = 0) {
+            float dx = directions[d].dx * lineLengths[l].width;
+            float dy = directions[d].dy * lineLengths[l].height;
+
+            context.x1 = (int) (((float) LCD_COLUMNS - dx) * 0.5f);
+            context.y1 = (int) (((float) LCD_ROWS - dy) * 0.5f);
+            context.x2 = context.x1 + (int) dx - (dx > 0.0f);
+            context.y2 = context.y1 + (int) dy - (dy > 0.0f);
+
+            int width = abs(context.x2 - context.x1);
+            int height = abs(context.y2 - context.y1);
+            int pixels = 1 + (width > height ? width : height);
+            Result result = {
+                    "renderer_draw_line", "", lineLengths[l].name, directions[d].name, 0,
+                    measure(run_line, &context), pixels, 0
+            };
+            print_result(format, &result, first);
+        }
+    }
+
+    if (format == FORMAT_JSON)
+        printf("\n  ]\n}\n");
+
+    free(context.frame);
+    return 0;
+}
@@ -0,0 +1,156 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "matrix4x4.h"
+#include "transform.h"
+
+// Minimum wall time spent in every measurement
+#define BENCH_MIN_SECONDS 0.2
+
+static double now_seconds(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double) time.tv_sec + (double) time.tv_nsec * 1e-9;
+}
+
+typedef struct {
+    int count;
+    Vector3* points;
+    Vector3* pointsOut;
+    float* x;
+    float* y;
+    float* z;
+    float* outX;
+    float* outY;
+    float* outZ;
+} Points;
+
+static Points points_create(int count) {
+    Points points = {
+            .count = count,
+            .points = malloc(sizeof(Vector3) * count),
+            .pointsOut = malloc(sizeof(Vector3) * count),
+            .x = malloc(sizeof(float) * count),
+            .y = malloc(sizeof(float) * count),
+            .z = malloc(sizeof(float) * count),
+            .outX = malloc(sizeof(float) * count),
+            .outY = malloc(sizeof(float) * count),
+            .outZ = malloc(sizeof(float) * count)
+    };
+
+    srand(1);
+    for (int i = 0; i < count; i++) {
+        points.x[i] = points.points[i].x = (float) rand() / (float) RAND_MAX * 2.0f - 1.0f;
+        points.y[i] = points.points[i].y = (float) rand() / (float) RAND_MAX * 2.0f - 1.0f;
+        points.z[i] = points.points[i].z = (float) rand() / (float) RAND_MAX * 2.0f + 1.0f;
+    }
+
+    return points;
+}
+
+static void points_destroy(Points* points) {
+    free(points->points);
+    free(points->pointsOut);
+    free(points->x);
+    free(points->y);
+    free(points->z);
+    free(points->outX);
+    free(points->outY);
+    free(points->outZ);
+}
+
+static void run_aos(const Matrix4x4* matrix, Points* points) {
+    for (int i = 0; i < points->count; i++)
+        vector3_multiply_matrix4x4(&points->points[i], &points->pointsOut[i], matrix);
+}
+
+static void run_soa_scalar(const Matrix4x4* matrix, Points* points) {
+    transform_points_scalar(matrix, points->x, points->y, points->z, points->outX, points->outY, points->outZ, points->count);
+}
+
+static void run_soa(const Matrix4x4* matrix, Points* points) {
+    transform_points(matrix, points->x, points->y, points->z, points->outX, points->outY, points->outZ, points->count);
+}
+
+// The affine kernels take the first three columns of the matrix, the work per point doesn't depend on its terms
+static Matrix4x3 affine_part(const Matrix4x4* matrix) {
+    Matrix4x3 affine;
+    for (int row = 0; row < 4; row++)
+        for (int column = 0; column < 3; column++)
+            affine.m[row][column] = matrix->m[row][column];
+    return affine;
+}
+
+static void run_affine_scalar(const Matrix4x4* matrix, Points* points) {
+    Matrix4x3 affine = affine_part(matrix);
+    transform_points_affine_scalar(&affine, points->x, points->y, points->z, points->outX, points->outY, points->outZ, points->count);
+}
+
+static void run_affine(const Matrix4x4* matrix, Points* points) {
+    Matrix4x3 affine = affine_part(matrix);
+    transform_points_affine(&affine, points->x, points->y, points->z, points->outX, points->outY, points->outZ, points->count);
+}
+
+/**
+ * @brief Repeats a kernel until BENCH_MIN_SECONDS have passed and returns the transformed points per second.
+ */
+
+static double measure(void (* kernel)(const Matrix4x4*, Points*), const Matrix4x4* matrix, Points* points) {
+    kernel(matrix, points);
+
+    long iterations = 0;
+    double start = now_seconds();
+    double elapsed;
+
+    do {
+        kernel(matrix, points);
+        iterations++;
+        elapsed = now_seconds() - start;
+    } while (elapsed < BENCH_MIN_SECONDS);
+
+    return (double) iterations * points->count / elapsed;
+}
+
+static float max_error(const Points* points) {
+    float error = 0.0f;
+    for (int i = 0; i < points->count; i++) {
+        error = fmaxf(error, fabsf(points->pointsOut[i].x - points->outX[i]));
+        error = fmaxf(error, fabsf(points->pointsOut[i].y - points->outY[i]));
+        error = fmaxf(error, fabsf(points->pointsOut[i].z - points->outZ[i]));
+    }
+    return error;
+}
+
+int main(void) {
+    Matrix4x4 matrix = matrix4X4_projection(60, 400.0f / 240.0f, 0.1f, 100.0f);
+    const int counts[] = {1000, 10000, 100000};
+
+    printf("backend: %s\n", transform_backend());
+    printf("%8s %16s %16s %16s %10s %12s %18s %18s\n", "points", "aos pts/s", "soa scalar pts/s", "soa simd pts/s", "speedup",
+           "max error", "affine scalar pts/s", "affine simd pts/s");
+
+    for (int c = 0; c < (int) (sizeof(counts) / sizeof(counts[0])); c++) {
+        Points points = points_create(counts[c]);
+
+        double aos = measure(run_aos, &matrix, &points);
+        double scalar = measure(run_soa_scalar, &matrix, &points);
+        double simd = measure(run_soa, &matrix, &points);
+        float error = max_error(&points);
+        double affineScalar = measure(run_affine_scalar, &matrix, &points);
+        double affine = measure(run_affine, &matrix, &points);
+
+        printf("%8d %16.0f %16.0f %16.0f %9.2fx %12g %18.0f %18.0f\n", counts[c], aos, scalar, simd, simd / aos, error,
+               affineScalar, affine);
+        points_destroy(&points);
+    }
+
+    return 0;
+}
@@ -0,0 +1,319 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <time.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include "host_api.h"
+
+static uint8_t frame[LCD_ROWS * LCD_ROWSIZE];
+
+static float crankAngle = 0.0f;
+static unsigned int displayScale = 1;
+static float refreshRate = 30.0f;
+
+static PDCallbackFunction* updateCallback = NULL;
+static void* updateUserdata = NULL;
+
+static int updatedFirst = LCD_ROWS;
+static int updatedLast = -1;
+static int updatedCount = 0;
+
+static struct timespec elapsedStart;
+
+static const char* fileError = NULL;
+
+// System
+
+static void* host_realloc(void* ptr, size_t size) {
+    if (size == 0) {
+        free(ptr);
+        return NULL;
+    }
+
+    return realloc(ptr, size);
+}
+
+static void host_error(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    fputs("error: ", stderr);
+    vfprintf(stderr, fmt, args);
+    fputc('\n', stderr);
+    va_end(args);
+}
+
+static void host_log(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    vprintf(fmt, args);
+    putchar('\n');
+    va_end(args);
+}
+
+static float host_get_crank_angle(void) {
+    return crankAngle;
+}
+
+static void host_draw_fps(int x, int y) {
+    (void) x;
+    (void) y;
+}
+
+static void host_set_update_callback(PDCallbackFunction* update, void* userdata) {
+    updateCallback = update;
+    updateUserdata = userdata;
+}
+
+static double host_seconds(const struct timespec* time) {
+    return (double) time->tv_sec + (double) time->tv_nsec * 1e-9;
+}
+
+static unsigned int host_get_current_time_milliseconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned int) (host_seconds(&now) * 1000.0);
+}
+
+static float host_get_elapsed_time(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (float) (host_seconds(&now) - host_seconds(&elapsedStart));
+}
+
+static void host_reset_elapsed_time(void) {
+    clock_gettime(CLOCK_MONOTONIC, &elapsedStart);
+}
+
+// Display
+
+static void host_set_refresh_rate(float rate) {
+    refreshRate = rate;
+}
+
+static void host_set_scale(unsigned int s) {
+    displayScale = s > 0 ? s : 1;
+}
+
+static float host_get_refresh_rate(void) {
+    return refreshRate;
+}
+
+// Graphics
+
+static void host_clear(LCDColor color) {
+    memset(frame, color == kColorBlack ? 0x00 : 0xFF, sizeof(frame));
+    updatedFirst = 0;
+    updatedLast = LCD_ROWS - 1;
+    updatedCount = LCD_ROWS;
+}
+
+static uint8_t* host_get_frame(void) {
+    return frame;
+}
+
+static void host_mark_updated_rows(int start, int end) {
+    if (start < 0) start = 0;
+    if (end >= LCD_ROWS) end = LCD_ROWS - 1;
+    if (start > end)
+        return;
+
+    if (start < updatedFirst) updatedFirst = start;
+    if (end > updatedLast) updatedLast = end;
+    updatedCount += end - start + 1;
+}
+
+// Fonts aren't available on the host, text is silently dropped. The placeholder is released through
+// host_realloc like a font of the SDK.
+static LCDFont* host_load_font(const char* path, const char** outErr) {
+    (void) path;
+    (void) outErr;
+
+    return malloc(1);
+}
+
+static void host_set_font(LCDFont* font) {
+    (void) font;
+}
+
+static int host_draw_text(const void* text, size_t len, PDStringEncoding encoding, int x, int y) {
+    (void) text;
+    (void) len;
+    (void) encoding;
+    (void) x;
+    (void) y;
+    return 0;
+}
+
+static void host_fill_rect(int x, int y, int width, int height, LCDColor color) {
+    if (color != kColorBlack && color != kColorWhite)
+        return;
+
+    for (int row = y < 0 ? 0 : y; row < y + height && row < LCD_ROWS; row++) {
+        for (int column = x < 0 ? 0 : x; column < x + width && column < LCD_COLUMNS; column++) {
+            uint8_t bit = (uint8_t) (0x80 >> (column & 7));
+            uint8_t* byte = &frame[row * LCD_ROWSIZE + column / 8];
+            *byte = color == kColorWhite ? (*byte | bit) : (*byte & ~bit);
+        }
+    }
+}
+
+// Files, paths are relative to the working directory
+
+static const char* host_file_geterr(void) {
+    return fileError;
+}
+
+static SDFile* host_file_open(const char* name, FileOptions mode) {
+    const char* fopenMode = (mode & kFileAppend) ? "ab" : (mode & kFileWrite) ? "wb" : "rb";
+
+    FILE* file = fopen(name, fopenMode);
+    if (file == NULL)
+        fileError = strerror(errno);
+
+    return file;
+}
+
+static int host_file_close(SDFile* file) {
+    return fclose(file) == 0 ? 0 : -1;
+}
+
+static int host_file_read(SDFile* file, void* buf, unsigned int len) {
+    size_t read = fread(buf, 1, len, file);
+    if (read < len && ferror(file)) {
+        fileError = strerror(errno);
+        return -1;
+    }
+    return (int) read;
+}
+
+static int host_file_write(SDFile* file, const void* buf, unsigned int len) {
+    size_t written = fwrite(buf, 1, len, file);
+    if (written < len) {
+        fileError = strerror(errno);
+        return -1;
+    }
+    return (int) written;
+}
+
+static int host_file_seek(SDFile* file, int pos, int whence) {
+    return fseek(file, pos, whence) == 0 ? 0 : -1;
+}
+
+static int host_file_tell(SDFile* file) {
+    return (int) ftell(file);
+}
+
+static int host_file_stat(const char* path, FileStat* result) {
+    struct stat info;
+    if (stat(path, &info) != 0) {
+        fileError = strerror(errno);
+        return -1;
+    }
+
+    memset(result, 0, sizeof(FileStat));
+    result->isdir = S_ISDIR(info.st_mode);
+    result->size = (unsigned int) info.st_size;
+    return 0;
+}
+
+static const struct playdate_sys hostSystem = {
+        .realloc = host_realloc,
+        .error = host_error,
+        .logToConsole = host_log,
+        .getCrankAngle = host_get_crank_angle,
+        .drawFPS = host_draw_fps,
+        .setUpdateCallback = host_set_update_callback,
+        .getCurrentTimeMilliseconds = host_get_current_time_milliseconds,
+        .getElapsedTime = host_get_elapsed_time,
+        .resetElapsedTime = host_reset_elapsed_time,
+};
+
+static const struct playdate_display hostDisplay = {
+        .setRefreshRate = host_set_refresh_rate,
+        .setScale = host_set_scale,
+        .getRefreshRate = host_get_refresh_rate,
+};
+
+static const struct playdate_graphics hostGraphics = {
+        .clear = host_clear,
+        .getFrame = host_get_frame,
+        .markUpdatedRows = host_mark_updated_rows,
+        .loadFont = host_load_font,
+        .setFont = host_set_font,
+        .drawText = host_draw_text,
+        .fillRect = host_fill_rect,
+};
+
+static const struct playdate_file hostFile = {
+        .geterr = host_file_geterr,
+        .open = host_file_open,
+        .close = host_file_close,
+        .read = host_file_read,
+        .write = host_file_write,
+        .seek = host_file_seek,
+        .tell = host_file_tell,
+        .stat = host_file_stat,
+};
+
+static PlaydateAPI hostApi = {
+        .system = &hostSystem,
+        .file = &hostFile,
+        .graphics = &hostGraphics,
+        .display = &hostDisplay,
+};
+
+PlaydateAPI* host_api(void) {
+    host_reset_elapsed_time();
+    return &hostApi;
+}
+
+void host_set_crank_angle(float angle) {
+    crankAngle = angle;
+}
+
+int host_update(void) {
+    if (updateCallback == NULL)
+        return 0;
+
+    return updateCallback(updateUserdata);
+}
+
+int host_take_updated_rows(int* first, int* last) {
+    int count = updatedCount;
+
+    if (first != NULL) *first = updatedFirst;
+    if (last != NULL) *last = updatedLast;
+
+    updatedFirst = LCD_ROWS;
+    updatedLast = -1;
+    updatedCount = 0;
+
+    return count;
+}
+
+int host_write_pbm(const char* path) {
+    FILE* file = fopen(path, "wb");
+    if (file == NULL)
+        return 0;
+
+    // The display shows the top left part of the frame buffer scaled up
+    int width = LCD_COLUMNS / (int) displayScale;
+    int height = LCD_ROWS / (int) displayScale;
+    int rowBytes = (width + 7) / 8;
+
+    fprintf(file, "P4\n%d %d\n", width, height);
+
+    // PBM uses 1 for black, the frame buffer 1 for white
+    for (int row = 0; row < height; row++) {
+        for (int byte = 0; byte < rowBytes; byte++)
+            fputc((uint8_t) ~frame[row * LCD_ROWSIZE + byte], file);
+    }
+
+    return fclose(file) == 0;
+}
@@ -0,0 +1,37 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#ifndef INC_3D_HOST_API_H
+#define INC_3D_HOST_API_H
+
+#include "pd_api.h"
+
+/**
+ * Returns the stub PlaydateAPI of the host build. The frame buffer is a plain LCD_ROWS * LCD_ROWSIZE byte array.
+ */
+PlaydateAPI* host_api(void);
+
+void host_set_crank_angle(float angle);
+
+/**
+ * Calls the update callback registered through setUpdateCallback once.
+ *
+ * @return The result of the callback, 0 if none was registered.
+ */
+int host_update(void);
+
+/**
+ * Returns the rows passed to markUpdatedRows since the last call, as the number of rows and their range.
+ */
+int host_take_updated_rows(int* first, int* last);
+
+/**
+ * Writes the visible part of the frame buffer as a binary PBM image.
+ *
+ * @param path The file to write.
+ * @return 1 on success, 0 if the file couldn't be written.
+ */
+int host_write_pbm(const char* path);
+
+#endif //INC_3D_HOST_API_H
@@ -0,0 +1,90 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#include <stdio.h>
+#include "host_api.h"
+#include "renderer/memory.h"
+
+int eventHandler(PlaydateAPI* pd, PDSystemEvent event, uint32_t arg);
+
+static void print_usage(const char* name) {
+    printf("usage: %s [-n frames] [-s crank step in degrees] [-o output directory for PBM frames]\n", name);
+}
+
+// Frames before heap allocations count as steady state, while caches fill up
+#define HOST_WARMUP_FRAMES 10
+
+/**
+ * @brief Runs the game headless, turning the crank by a fixed step every frame.
+ *
+ * Prints the time spent in the update callback, the number of rows pushed to the display and the heap use,
+ * and optionally dumps every frame as a PBM image.
+ */
+
+int main(int argc, char** argv) {
+    int frames = 360;
+    float step = 1.0f;
+    const char* output = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            step = (float) atof(argv[++i]);
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    PlaydateAPI* api = host_api();
+    eventHandler(api, kEventInit, 0);
+
+    float totalTime = 0.0f, minTime = 1e9f, maxTime = 0.0f;
+    long totalRows = 0;
+    int maxFrameAllocations = 0;
+
+    for (int i = 0; i < frames; i++) {
+        host_set_crank_angle(fmodf((float) i * step, 360.0f));
+
+        api->system->resetElapsedTime();
+        host_update();
+        float time = api->system->getElapsedTime();
+
+        totalTime += time;
+        if (time < minTime) minTime = time;
+        if (time > maxTime) maxTime = time;
+        totalRows += host_take_updated_rows(NULL, NULL);
+
+        if (i >= HOST_WARMUP_FRAMES && memory_stats()->frameAllocations > maxFrameAllocations)
+            maxFrameAllocations = memory_stats()->frameAllocations;
+
+        if (output != NULL) {
+            char path[1024];
+            snprintf(path, sizeof(path), "%s/frame%04d.pbm", output, i);
+
+            if (!host_write_pbm(path)) {
+                fprintf(stderr, "Couldn't write %s\n", path);
+                return 1;
+            }
+        }
+    }
+
+    eventHandler(api, kEventTerminate, 0);
+
+    if (frames > 0) {
+        printf("frames: %d\n", frames);
+        printf("update ms: avg %.3f min %.3f max %.3f\n",
+               1000.0f * totalTime / (float) frames, 1000.0f * minTime, 1000.0f * maxTime);
+        printf("rows pushed per frame: %.1f\n", (double) totalRows / frames);
+        printf("heap: peak %zu bytes, %d allocations, max %d per frame after %d frames\n",
+               memory_stats()->peakBytes, memory_stats()->totalAllocations, maxFrameAllocations, HOST_WARMUP_FRAMES);
+        printf("heap after shutdown: %zu bytes in %d allocations\n",
+               memory_stats()->liveBytes, memory_stats()->liveAllocations);
+    }
+
+    return 0;
+}
@@ -0,0 +1,127 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#ifndef PLAYDATEAPI_H
+#define PLAYDATEAPI_H
+
+/**
+ * Minimal stand-in for the Playdate SDK header used by the headless host build. Only declares the parts of
+ * the API the game uses, with the same names and signatures as the SDK, backed by host_api.c.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define LCD_COLUMNS 400
+#define LCD_ROWS 240
+#define LCD_ROWSIZE 52
+
+typedef uintptr_t LCDColor;
+
+typedef enum {
+    kColorBlack,
+    kColorWhite,
+    kColorClear,
+    kColorXOR
+} LCDSolidColor;
+
+typedef enum {
+    kASCIIEncoding,
+    kUTF8Encoding,
+    k16BitLEEncoding
+} PDStringEncoding;
+
+typedef struct LCDFont LCDFont;
+
+typedef void SDFile;
+
+typedef enum {
+    kFileRead = (1 << 0),
+    kFileReadData = (1 << 1),
+    kFileWrite = (1 << 2),
+    kFileAppend = (2 << 2)
+} FileOptions;
+
+#ifndef SEEK_SET
+#define SEEK_SET 0
+#define SEEK_CUR 1
+#define SEEK_END 2
+#endif
+
+typedef struct {
+    int isdir;
+    unsigned int size;
+    int m_year;
+    int m_month;
+    int m_day;
+    int m_hour;
+    int m_minute;
+    int m_second;
+} FileStat;
+
+typedef enum {
+    kEventInit,
+    kEventInitLua,
+    kEventLock,
+    kEventUnlock,
+    kEventPause,
+    kEventResume,
+    kEventTerminate,
+    kEventKeyPressed,
+    kEventKeyReleased,
+    kEventLowPower
+} PDSystemEvent;
+
+typedef int PDCallbackFunction(void* userdata);
+
+struct playdate_sys {
+    void* (*realloc)(void* ptr, size_t size);
+    void (*error)(const char* fmt, ...);
+    void (*logToConsole)(const char* fmt, ...);
+    float (*getCrankAngle)(void);
+    void (*drawFPS)(int x, int y);
+    void (*setUpdateCallback)(PDCallbackFunction* update, void* userdata);
+    unsigned int (*getCurrentTimeMilliseconds)(void);
+    float (*getElapsedTime)(void);
+    void (*resetElapsedTime)(void);
+};
+
+struct playdate_display {
+    void (*setRefreshRate)(float rate);
+    void (*setScale)(unsigned int s);
+    float (*getRefreshRate)(void);
+};
+
+struct playdate_graphics {
+    void (*clear)(LCDColor color);
+    uint8_t* (*getFrame)(void);
+    void (*markUpdatedRows)(int start, int end);
+    LCDFont* (*loadFont)(const char* path, const char** outErr);
+    void (*setFont)(LCDFont* font);
+    int (*drawText)(const void* text, size_t len, PDStringEncoding encoding, int x, int y);
+    void (*fillRect)(int x, int y, int width, int height, LCDColor color);
+};
+
+struct playdate_file {
+    const char* (*geterr)(void);
+    SDFile* (*open)(const char* name, FileOptions mode);
+    int (*close)(SDFile* file);
+    int (*read)(SDFile* file, void* buf, unsigned int len);
+    int (*write)(SDFile* file, const void* buf, unsigned int len);
+    int (*seek)(SDFile* file, int pos, int whence);
+    int (*tell)(SDFile* file);
+    int (*stat)(const char* path, FileStat* stat);
+};
+
+typedef struct PlaydateAPI {
+    const struct playdate_sys* system;
+    const struct playdate_file* file;
+    const struct playdate_graphics* graphics;
+    const struct playdate_display* display;
+} PlaydateAPI;
+
+#endif //PLAYDATEAPI_H
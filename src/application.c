@@ -2,13 +2,47 @@
 // Created by Michael Berger on 7/14/23.
 //
 
+#include <string.h>
 #include "application.h"
 #include "renderer/renderer.h"
+#include "renderer/memory.h"
+#include "cube_mesh.h"
+
+// Degrees between two cached frames
+#define APPLICATION_FRAME_CACHE_STEP 0.5f
+
+// Bytes the cached frames may use
+#define APPLICATION_FRAME_CACHE_BUDGET (256 * 1024)
+
+// Binary mesh drawn instead of the cube if it exists, in the data folder or the game bundle
+#define APPLICATION_MODEL_PATH "model.mesh"
+
+// World streamed in chunks instead of the model if it exists
+#define APPLICATION_WORLD_PATH "world.world"
+
+// Bytes the loaded world chunks may use
+#define APPLICATION_WORLD_BUDGET (512 * 1024)
+
+// Chunks closer to the camera than this share of its distance to the world's center are loaded
+#define APPLICATION_WORLD_RANGE 1.0f
+
+// Seconds kept free at the end of a frame, jobs only run before that
+#define APPLICATION_JOB_MARGIN 0.002f
 
 static void application_init(Application* app);
 
+static void application_init_frame_cache(Application* app);
+
+static const Mesh* application_load_model(Application* app);
+
+static JobStatus application_stream_world(Job* job);
+
+static int application_file_exists(const Application* app, const char* path);
+
 Application* application_create_default(PlaydateAPI* api) {
-    Application* app = malloc(sizeof(Application));
+    memory_init(api);
+
+    Application* app = memory_alloc(sizeof(Application));
     app->api = api;
     app->renderer = renderer_create(api, 50, 2);
 
@@ -18,14 +52,135 @@ Application* application_create_default(PlaydateAPI* api) {
 }
 
 void application_destroy(Application* app) {
-    renderer_cleanup(app->renderer);
-    free(app);
+    renderer_cleanup(app->renderer, app->api);
+    scheduler_destroy(&app->scheduler);
+    frame_cache_destroy(&app->frameCache);
+    world_stream_close(&app->world);
+    scene_destroy(app->scene);
+    mesh_file_unload(&app->model);
+    memory_free(app);
 }
 
-static void application_init(Application* app) { }
+static void application_init(Application* app) {
+    app->scene = scene_create();
+
+    // Place the model in front of the camera
+    app->pivotNode = scene_add(app->scene, NULL, NULL);
+    scene_node_set_position(app->pivotNode, (Vector3) {.x = 0.0f, .y = 0.0f, .z = 3.0f});
+    app->modelNode = scene_add(app->scene, app->pivotNode, NULL);
+
+    BoundingSphere bounds;
+    memset(&app->model, 0, sizeof(MeshFile));
+    memset(&app->world, 0, sizeof(WorldStream));
+    app->worldChanged = 0;
+    scheduler_init(&app->scheduler, app->api);
+
+    // Without its job nothing of the world would ever be streamed in
+    if (application_file_exists(app, APPLICATION_WORLD_PATH) &&
+        world_stream_open(&app->world, app->api, APPLICATION_WORLD_PATH, app->scene, app->modelNode, APPLICATION_WORLD_BUDGET) &&
+        scheduler_add(&app->scheduler, application_stream_world, app, JOB_PRIORITY_NORMAL) != NULL) {
+        bounds = app->world.bounds;
+    } else {
+        world_stream_close(&app->world);
+
+        const Mesh* mesh = application_load_model(app);
+        scene_add(app->scene, app->modelNode, mesh);
+        bounds = mesh->bounds;
+    }
+
+    float scale = cubeMesh.bounds.radius / bounds.radius;
+    scene_node_set_scale(app->modelNode, (Vector3) {.x = scale, .y = scale, .z = scale});
+    scene_node_set_position(app->modelNode, vector3_scalar_multiply(bounds.center, -scale));
+
+    application_init_frame_cache(app);
+    quality_governor_init(&app->governor, (float) app->renderer->refreshRate);
+}
+
+static void application_init_frame_cache(Application* app) {
+    frame_cache_init(
+            &app->frameCache,
+            app->renderer->rows,
+            app->renderer->columns,
+            APPLICATION_FRAME_CACHE_STEP,
+            APPLICATION_FRAME_CACHE_BUDGET
+    );
+
+    // No valid key, so the next update always draws
+    app->lastKey = -1;
+}
+
+static const Mesh* application_load_model(Application* app) {
+    if (application_file_exists(app, APPLICATION_MODEL_PATH) && mesh_file_load(&app->model, app->api, APPLICATION_MODEL_PATH))
+        return &app->model.mesh;
+
+    return &cubeMesh;
+}
+
+/**
+ * @brief Job reading one piece of the world chunks near the camera.
+ */
+
+static JobStatus application_stream_world(Job* job) {
+    Application* app = job->context;
+
+    Matrix4x3 toWorld;
+    if (!matrix4x3_inverse(&app->modelNode->worldMatrix, &toWorld))
+        return JOB_WAIT;
+
+    // Chunks are in the space of the model node
+    Vector3 viewer;
+    vector3_multiply_matrix4x3(&app->renderer->cameraPosition, &viewer, &toWorld);
+
+    float radius = vector3_length(vector3_subtract(viewer, app->world.bounds.center)) * APPLICATION_WORLD_RANGE;
+    if (world_stream_update(&app->world, viewer, radius, 0.0f) > 0)
+        app->worldChanged = 1;
+
+    return app->world.idle ? JOB_WAIT : JOB_CONTINUE;
+}
+
+static int application_file_exists(const Application* app, const char* path) {
+    FileStat stat;
+    return app->api->file->stat(path, &stat) == 0;
+}
 
 int application_update(Application* app, PlaydateAPI* api) {
-    renderer_draw(app->renderer, api);
+    // The frame time of the governor and the stage timers of the profiler are measured from here
+    api->system->resetElapsedTime();
+    memory_begin_frame();
+
+    int key = frame_cache_key(&app->frameCache, api->system->getCrankAngle());
+
+    if (key != app->lastKey) {
+        app->lastKey = key;
+
+        // Drawn at the quantized angle, so a cached frame looks the same as a drawn one
+        float theta = frame_cache_angle(&app->frameCache, key) * PI / 180.0f;
+        scene_node_set_rotation(app->pivotNode, (Vector3) {.x = theta, .y = theta, .z = theta});
+
+        int cached = renderer_draw_cached(app->renderer, api, app->scene, &app->frameCache, key);
+
+        // Cached frames were drawn at another quality, start over with an empty cache
+        if (!cached && quality_governor_update(&app->governor, api->system->getElapsedTime())) {
+            renderer_set_quality(app->renderer, api, quality_governor_level(&app->governor));
+            frame_cache_destroy(&app->frameCache);
+            application_init_frame_cache(app);
+        }
+
+#ifdef RENDERER_PROFILE
+        renderer_draw_profiler(app->renderer);
+#endif
+    }
+
+    // Jobs run after drawing, so they don't count as frame time for the governor
+    scheduler_run(&app->scheduler, app->governor.budget - APPLICATION_JOB_MARGIN);
+
+    // Cached frames don't show the new chunks
+    if (app->worldChanged) {
+        app->worldChanged = 0;
+        frame_cache_clear(&app->frameCache);
+        app->lastKey = -1;
+    }
+
     api->system->drawFPS(0, 0);
     return 1;
 }
@@ -7,10 +7,37 @@
 
 #include <pd_api.h>
 #include "renderer/renderer.h"
+#include "renderer/scene.h"
+#include "renderer/mesh.h"
+#include "renderer/frame_cache.h"
+#include "renderer/mesh_file.h"
+#include "renderer/world_stream.h"
+#include "renderer/scheduler.h"
 
 typedef struct {
     PlaydateAPI* api;
     Renderer* renderer;
+
+    Scene* scene;
+    SceneNode* pivotNode;   // Rotated by the crank
+    SceneNode* modelNode;   // Scales the model to the size of the cube and centers it on the pivot
+
+    // Model loaded at startup instead of the cube, data is NULL if there is none
+    MeshFile model;
+
+    // World streamed in instead of the model, chunks is NULL if there is none
+    WorldStream world;
+    int worldChanged;       // Chunks were added or removed since the last draw
+
+    // Deferred work, run in the time left after drawing
+    Scheduler scheduler;
+
+    // The image only depends on the crank angle, so frames are cached by angle
+    FrameCache frameCache;
+    int lastKey;
+
+    // Lowers the render quality while frames miss the refresh rate
+    QualityGovernor governor;
 } Application;
 
 Application* application_create_default(PlaydateAPI* api);
@@ -19,6 +19,8 @@ __declspec(dllexport)
  * @param*/
  
 int eventHandler(PlaydateAPI* pd, PDSystemEvent event, uint32_t arg) {
+    (void) arg;
+
     if (event == kEventInit) {
         application = application_create_default(pd);
         pd->system->setUpdateCallback((int (*)(void*)) updateApplication, pd);
@@ -0,0 +1,75 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#include "arena.h"
+#include "memory.h"
+
+void arena_init(Arena* arena, size_t capacity) {
+    arena->data = capacity > 0 ? memory_alloc(capacity) : NULL;
+    arena->capacity = arena->data != NULL ? capacity : 0;
+    arena->used = 0;
+    arena->peak = 0;
+}
+
+void arena_destroy(Arena* arena) {
+    memory_free(arena->data);
+    arena->data = NULL;
+    arena->capacity = 0;
+    arena->used = 0;
+}
+
+/**
+ * @brief Releases every allocation, the block is kept.
+ */
+
+void arena_reset(Arena* arena) {
+    arena->used = 0;
+}
+
+/**
+ * @brief Grows the block to at least the given capacity. Only allowed while nothing is allocated, since the
+ * block may move.
+ *
+ * Grows at least by half, so a slowly growing demand doesn't reallocate every time.
+ *
+ * @param arena The empty arena.
+ * @param capacity Bytes needed.
+ * @return 1 on success, 0 if the block couldn't grow, the old block is kept then.
+ */
+
+int arena_reserve(Arena* arena, size_t capacity) {
+    if (capacity <= arena->capacity)
+        return 1;
+
+    size_t grown = arena->capacity + arena->capacity / 2;
+    if (grown < capacity)
+        grown = capacity;
+
+    uint8_t* data = memory_realloc(arena->data, grown);
+    if (data == NULL)
+        return 0;
+
+    arena->data = data;
+    arena->capacity = grown;
+    return 1;
+}
+
+/**
+ * @brief Takes the next ARENA_SIZE(size) bytes of the block.
+ *
+ * @return The allocation, NULL if the arena is full.
+ */
+
+void* arena_alloc(Arena* arena, size_t size) {
+    size_t bytes = ARENA_SIZE(size);
+    if (arena->data == NULL || bytes > arena->capacity - arena->used)
+        return NULL;
+
+    void* pointer = arena->data + arena->used;
+    arena->used += bytes;
+    if (arena->used > arena->peak)
+        arena->peak = arena->used;
+
+    return pointer;
+}
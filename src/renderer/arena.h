@@ -0,0 +1,38 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#ifndef INC_3D_ARENA_H
+#define INC_3D_ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Alignment of every allocation, enough for any type of the pipeline
+#define ARENA_ALIGNMENT 8
+
+// Bytes an allocation of the given size takes up in an arena
+#define ARENA_SIZE(size) (((size) + ARENA_ALIGNMENT - 1) & ~(size_t) (ARENA_ALIGNMENT - 1))
+
+/**
+ * Linear allocator over one block. Allocations only bump an offset and are all released at once by a reset,
+ * so data that lives for a single frame costs no heap traffic.
+ */
+typedef struct {
+    uint8_t* data;
+    size_t capacity;
+    size_t used;
+    size_t peak;        // Highest used so far
+} Arena;
+
+void arena_init(Arena* arena, size_t capacity);
+
+void arena_destroy(Arena* arena);
+
+void arena_reset(Arena* arena);
+
+int arena_reserve(Arena* arena, size_t capacity);
+
+void* arena_alloc(Arena* arena, size_t size);
+
+#endif //INC_3D_ARENA_H
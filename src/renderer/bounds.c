@@ -0,0 +1,105 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#include <math.h>
+#include "bounds.h"
+
+BoundingSphere bounding_sphere_empty(void) {
+    BoundingSphere sphere = {.center = {0.0f, 0.0f, 0.0f}, .radius = -1.0f};
+    return sphere;
+}
+
+/**
+ * @brief Calculates a bounding sphere around a set of points.
+ *
+ * Uses the center of the axis-aligned bounds and the largest distance from it. Not the minimal sphere,
+ * but never more than sqrt(3) times its radius and cheap enough to run on load.
+ *
+ * @param points The points to enclose.
+ * @param count Number of points.
+ * @return The bounding sphere, empty if there are no points.
+ */
+
+BoundingSphere bounding_sphere_from_points(const Vector3* points, int count) {
+    if (count <= 0)
+        return bounding_sphere_empty();
+
+    Vector3 minimum = points[0];
+    Vector3 maximum = points[0];
+
+    for (int i = 1; i < count; i++) {
+        minimum.x = fminf(minimum.x, points[i].x);
+        minimum.y = fminf(minimum.y, points[i].y);
+        minimum.z = fminf(minimum.z, points[i].z);
+        maximum.x = fmaxf(maximum.x, points[i].x);
+        maximum.y = fmaxf(maximum.y, points[i].y);
+        maximum.z = fmaxf(maximum.z, points[i].z);
+    }
+
+    BoundingSphere sphere = {.center = vector3_scalar_multiply(vector3_add(minimum, maximum), 0.5f), .radius = 0.0f};
+
+    for (int i = 0; i < count; i++)
+        sphere.radius = fmaxf(sphere.radius, vector3_squared_length(vector3_subtract(points[i], sphere.center)));
+
+    sphere.radius = sqrtf(sphere.radius);
+    return sphere;
+}
+
+/**
+ * @brief Calculates the smallest sphere enclosing two spheres.
+ *
+ * @param a The first sphere, may be empty.
+ * @param b The second sphere, may be empty.
+ * @return The enclosing sphere.
+ */
+
+BoundingSphere bounding_sphere_merge(BoundingSphere a, BoundingSphere b) {
+    if (a.radius < 0.0f)
+        return b;
+    if (b.radius < 0.0f)
+        return a;
+
+    Vector3 offset = vector3_subtract(b.center, a.center);
+    float distance = vector3_length(offset);
+
+    // One sphere already contains the other
+    if (distance + b.radius <= a.radius)
+        return a;
+    if (distance + a.radius <= b.radius)
+        return b;
+
+    float radius = (distance + a.radius + b.radius) * 0.5f;
+
+    BoundingSphere sphere = {
+            .center = vector3_add(a.center, vector3_scalar_multiply(offset, (radius - a.radius) / distance)),
+            .radius = radius
+    };
+    return sphere;
+}
+
+/**
+ * @brief Transforms a bounding sphere by an affine matrix.
+ *
+ * The radius grows with the largest scale of the matrix, so the sphere stays conservative under
+ * non-uniform scaling.
+ *
+ * @param sphere The sphere to transform.
+ * @param matrix The affine transformation.
+ * @return The transformed sphere.
+ */
+
+BoundingSphere bounding_sphere_transform(BoundingSphere sphere, const Matrix4x3* matrix) {
+    if (sphere.radius < 0.0f)
+        return sphere;
+
+    float scale = 0.0f;
+    for (int row = 0; row < 3; row++) {
+        Vector3 axis = {matrix->m[row][0], matrix->m[row][1], matrix->m[row][2]};
+        scale = fmaxf(scale, vector3_squared_length(axis));
+    }
+
+    BoundingSphere result = {.radius = sphere.radius * sqrtf(scale)};
+    vector3_multiply_matrix4x3(&sphere.center, &result.center, matrix);
+    return result;
+}
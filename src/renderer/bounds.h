@@ -0,0 +1,23 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#ifndef INC_3D_BOUNDS_H
+#define INC_3D_BOUNDS_H
+
+#include "matrix4x3.h"
+
+typedef struct {
+    Vector3 center;
+    float radius;   // Negative for an empty sphere
+} BoundingSphere;
+
+BoundingSphere bounding_sphere_empty(void);
+
+BoundingSphere bounding_sphere_from_points(const Vector3* points, int count);
+
+BoundingSphere bounding_sphere_merge(BoundingSphere a, BoundingSphere b);
+
+BoundingSphere bounding_sphere_transform(BoundingSphere sphere, const Matrix4x3* matrix);
+
+#endif //INC_3D_BOUNDS_H
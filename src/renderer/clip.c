@@ -0,0 +1,187 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#include "clip.h"
+
+/**
+ * @brief Creates the clip volume of a frame.
+ *
+ * @param near The distance of the near plane. The projection puts the view-space depth into w.
+ * @param frame_width Width of the frame in pixels.
+ * @param frame_height Height of the frame in pixels.
+ * @return The clip volume with a guard band of CLIP_GUARD_BAND_PIXELS around the frame.
+ */
+
+ClipVolume clip_volume(float near, int frame_width, int frame_height) {
+    ClipVolume volume = {
+            .near = near,
+            .guardX = 1.0f + 2.0f * CLIP_GUARD_BAND_PIXELS / (float) frame_width,
+            .guardY = 1.0f + 2.0f * CLIP_GUARD_BAND_PIXELS / (float) frame_height
+    };
+    return volume;
+}
+
+/**
+ * @brief Signed distance of a clip-space vertex to one of the clip planes, positive on the inside.
+ */
+
+static float plane_distance(const ClipVolume* volume, int plane, const Vector4* vertex) {
+    switch (plane) {
+        case CLIP_NEAR:
+            return vertex->w - volume->near;
+        case CLIP_LEFT:
+            return vertex->x + vertex->w;
+        case CLIP_RIGHT:
+            return vertex->w - vertex->x;
+        case CLIP_BOTTOM:
+            return vertex->y + vertex->w;
+        case CLIP_TOP:
+            return vertex->w - vertex->y;
+        case CLIP_GUARD_LEFT:
+            return vertex->x + volume->guardX * vertex->w;
+        case CLIP_GUARD_RIGHT:
+            return volume->guardX * vertex->w - vertex->x;
+        case CLIP_GUARD_BOTTOM:
+            return vertex->y + volume->guardY * vertex->w;
+        case CLIP_GUARD_TOP:
+            return volume->guardY * vertex->w - vertex->y;
+        default:
+            return 0.0f;
+    }
+}
+
+/**
+ * @brief Calculates the outcode of a clip-space vertex.
+ *
+ * @param volume The clip volume.
+ * @param vertex The clip-space vertex.
+ * @return Bit set of the ClipPlane values the vertex lies outside of.
+ */
+
+int clip_outcode(const ClipVolume* volume, const Vector4* vertex) {
+    int outcode = 0;
+
+    for (int plane = CLIP_NEAR; plane <= CLIP_GUARD_TOP; plane <<= 1) {
+        if (plane_distance(volume, plane, vertex) < 0.0f)
+            outcode |= plane;
+    }
+
+    return outcode;
+}
+
+/**
+ * @brief Clips a convex polygon against a set of clip planes.
+ *
+ * Sutherland-Hodgman clipping in homogeneous clip space, one plane after another and starting with the near
+ * plane, so no vertex with w <= 0 ever reaches the perspective divide.
+ *
+ * @param volume The clip volume.
+ * @param planes Bit set of the ClipPlane values to clip against.
+ * @param in The polygon vertices.
+ * @param count Number of polygon vertices.
+ * @param out Receives the clipped polygon, room for CLIP_MAX_VERTICES vertices.
+ * @return Number of vertices of the clipped polygon, less than 3 if nothing is left.
+ */
+
+int clip_polygon(const ClipVolume* volume, int planes, const Vector4* in, int count, Vector4* out) {
+    Vector4 buffers[2][CLIP_MAX_VERTICES];
+    const Vector4* source = in;
+    int buffer = 0;
+
+    for (int plane = CLIP_NEAR; plane <= CLIP_GUARD_TOP && count >= 3; plane <<= 1) {
+        if (!(planes & plane))
+            continue;
+
+        Vector4* target = buffers[buffer];
+        int clippedCount = 0;
+
+        const Vector4* previous = &source[count - 1];
+        float previousDistance = plane_distance(volume, plane, previous);
+
+        for (int i = 0; i < count; i++) {
+            const Vector4* current = &source[i];
+            float currentDistance = plane_distance(volume, plane, current);
+
+            if ((previousDistance >= 0.0f) != (currentDistance >= 0.0f) && clippedCount < CLIP_MAX_VERTICES) {
+                float t = previousDistance / (previousDistance - currentDistance);
+                target[clippedCount++] = (Vector4) {
+                        .x = previous->x + (current->x - previous->x) * t,
+                        .y = previous->y + (current->y - previous->y) * t,
+                        .z = previous->z + (current->z - previous->z) * t,
+                        .w = previous->w + (current->w - previous->w) * t
+                };
+            }
+
+            if (currentDistance >= 0.0f && clippedCount < CLIP_MAX_VERTICES)
+                target[clippedCount++] = *current;
+
+            previous = current;
+            previousDistance = currentDistance;
+        }
+
+        source = target;
+        count = clippedCount;
+        buffer ^= 1;
+    }
+
+    for (int i = 0; i < count; i++)
+        out[i] = source[i];
+
+    return count;
+}
+
+/**
+ * @brief Clips a screen-space line segment to the rectangle [0, xMax] x [0, yMax].
+ *
+ * Liang-Barsky clipping, so line drawing only ever steps over pixels that are inside the frame.
+ *
+ * @param x1 X-coordinate of the segment start, updated in place.
+ * @param y1 Y-coordinate of the segment start, updated in place.
+ * @param x2 X-coordinate of the segment end, updated in place.
+ * @param y2 Y-coordinate of the segment end, updated in place.
+ * @param xMax Largest x-coordinate inside the rectangle.
+ * @param yMax Largest y-coordinate inside the rectangle.
+ * @return 1 if a part of the segment is inside the rectangle, 0 otherwise.
+ */
+
+int clip_segment(float* x1, float* y1, float* x2, float* y2, float xMax, float yMax) {
+    float dx = *x2 - *x1;
+    float dy = *y2 - *y1;
+
+    float p[4] = {-dx, dx, -dy, dy};
+    float q[4] = {*x1, xMax - *x1, *y1, yMax - *y1};
+
+    float tStart = 0.0f;
+    float tEnd = 1.0f;
+
+    for (int i = 0; i < 4; i++) {
+        if (p[i] == 0.0f) {
+            if (q[i] < 0.0f)
+                return 0;
+            continue;
+        }
+
+        float t = q[i] / p[i];
+        if (p[i] < 0.0f) {
+            if (t > tEnd)
+                return 0;
+            if (t > tStart)
+                tStart = t;
+        } else {
+            if (t < tStart)
+                return 0;
+            if (t < tEnd)
+                tEnd = t;
+        }
+    }
+
+    float startX = *x1, startY = *y1;
+
+    *x1 = startX + dx * tStart;
+    *y1 = startY + dy * tStart;
+    *x2 = startX + dx * tEnd;
+    *y2 = startY + dy * tEnd;
+
+    return 1;
+}
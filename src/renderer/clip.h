@@ -0,0 +1,48 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#ifndef INC_3D_CLIP_H
+#define INC_3D_CLIP_H
+
+#include "vector4.h"
+
+// Screen-space distance (in pixels) outside the frame that triangles may reach before they get clipped.
+#define CLIP_GUARD_BAND_PIXELS 2048
+
+// Each clip plane can add one vertex to a triangle.
+#define CLIP_MAX_VERTICES 12
+
+enum ClipPlane {
+    CLIP_NEAR = 1 << 0,
+    CLIP_LEFT = 1 << 1,
+    CLIP_RIGHT = 1 << 2,
+    CLIP_BOTTOM = 1 << 3,
+    CLIP_TOP = 1 << 4,
+    CLIP_GUARD_LEFT = 1 << 5,
+    CLIP_GUARD_RIGHT = 1 << 6,
+    CLIP_GUARD_BOTTOM = 1 << 7,
+    CLIP_GUARD_TOP = 1 << 8,
+};
+
+// Planes a triangle is rejected by when all its vertices are outside the same one.
+#define CLIP_REJECT_PLANES (CLIP_NEAR | CLIP_LEFT | CLIP_RIGHT | CLIP_BOTTOM | CLIP_TOP)
+
+// Planes a triangle is actually clipped against. The screen edges are left to the rasterizer scissor.
+#define CLIP_CLIP_PLANES (CLIP_NEAR | CLIP_GUARD_LEFT | CLIP_GUARD_RIGHT | CLIP_GUARD_BOTTOM | CLIP_GUARD_TOP)
+
+typedef struct {
+    float near;     // Clip-space w of the near plane
+    float guardX;   // Guard band half-width in normalized device coordinates
+    float guardY;   // Guard band half-height in normalized device coordinates
+} ClipVolume;
+
+ClipVolume clip_volume(float near, int frame_width, int frame_height);
+
+int clip_outcode(const ClipVolume* volume, const Vector4* vertex);
+
+int clip_polygon(const ClipVolume* volume, int planes, const Vector4* in, int count, Vector4* out);
+
+int clip_segment(float* x1, float* y1, float* x2, float* y2, float xMax, float yMax);
+
+#endif //INC_3D_CLIP_H
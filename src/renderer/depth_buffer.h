@@ -0,0 +1,50 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#ifndef INC_3D_DEPTH_BUFFER_H
+#define INC_3D_DEPTH_BUFFER_H
+
+#include <stdint.h>
+
+// Size of the square pixel tiles with a coarse depth, the same as the rasterizer blocks
+#define DEPTH_BUFFER_TILE_SIZE 8
+
+// Depth of a cleared pixel, the far plane
+#define DEPTH_BUFFER_FAR 0xFFFF
+
+/**
+ * 16-bit depth per pixel, 0 at the near plane. Every 8x8 tile also keeps the farthest depth of its pixels,
+ * so whole triangles and blocks lying behind it can be rejected without touching single pixels.
+ */
+typedef struct {
+    int rows;
+    int columns;
+    int tileRows;
+    int tileColumns;
+    uint16_t* depth;
+    uint16_t* tileMax;
+} DepthBuffer;
+
+void depth_buffer_init(DepthBuffer* buffer, int rows, int columns);
+
+void depth_buffer_destroy(DepthBuffer* buffer);
+
+void depth_buffer_clear(DepthBuffer* buffer);
+
+void depth_buffer_update_tile(DepthBuffer* buffer, int tileX, int tileY);
+
+uint16_t depth_buffer_max_in_rect(const DepthBuffer* buffer, int x0, int y0, int x1, int y1);
+
+/**
+ * Rounds a depth in buffer units, the normalized depth times DEPTH_BUFFER_FAR, to the depth stored in the buffer.
+ */
+static inline uint16_t depth_buffer_quantize(float depth) {
+    if (!(depth > 0.0f))
+        return 0;
+    if (depth >= (float) DEPTH_BUFFER_FAR)
+        return DEPTH_BUFFER_FAR;
+    return (uint16_t) (depth + 0.5f);
+}
+
+#endif //INC_3D_DEPTH_BUFFER_H
@@ -0,0 +1,119 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#include <stdlib.h>
+#include <string.h>
+#include "depth_sort.h"
+
+#define DEPTH_SORT_RADIX 256
+
+void depth_sort_init(DepthSort* sort) {
+    sort->capacity = 0;
+    sort->keys = NULL;
+    sort->order = NULL;
+    sort->scratch = NULL;
+}
+
+/**
+ * @brief Takes the buffers for the given number of items from an arena, they are valid until its next reset.
+ *
+ * @param sort The sort buffers.
+ * @param arena The arena, must have room for depth_sort_arena_size(count) bytes.
+ * @param count Number of items.
+ * @return 1 on success, 0 if the arena ran out.
+ */
+
+int depth_sort_alloc(DepthSort* sort, Arena* arena, int count) {
+    sort->keys = arena_alloc(arena, sizeof(uint16_t) * count);
+    sort->order = arena_alloc(arena, sizeof(int) * count);
+    sort->scratch = arena_alloc(arena, sizeof(int) * count);
+    sort->capacity = count;
+    return sort->keys != NULL && sort->order != NULL && sort->scratch != NULL;
+}
+
+/**
+ * @brief Bytes depth_sort_alloc takes from an arena.
+ */
+
+size_t depth_sort_arena_size(int count) {
+    return ARENA_SIZE(sizeof(uint16_t) * count) + 2 * ARENA_SIZE(sizeof(int) * count);
+}
+
+/**
+ * @brief Quantizes a view depth into a key that sorts far items first.
+ *
+ * @param depth The view-space depth.
+ * @param near Depth of the near plane, gets the largest key.
+ * @param far Depth of the far plane, gets key 0.
+ * @return The sort key.
+ */
+
+uint16_t depth_sort_key(float depth, float near, float far) {
+    float t = (far - depth) / (far - near);
+
+    if (!(t > 0.0f))
+        return 0;
+    if (t >= 1.0f)
+        return UINT16_MAX;
+
+    return (uint16_t) (t * (float) UINT16_MAX);
+}
+
+/**
+ * @brief Sorts the items by their keys in O(n).
+ *
+ * A stable least significant digit radix sort with two 8-bit passes. Both histograms are built in a single
+ * pass over the keys, and a pass is skipped when all keys share the same digit.
+ *
+ * @param sort The sort buffers, keys must hold the key of every item.
+ * @param count Number of items.
+ * @return The item indices in ascending key order, valid until the next call.
+ */
+
+const int* depth_sort_order(DepthSort* sort, int count) {
+    int low[DEPTH_SORT_RADIX];
+    int high[DEPTH_SORT_RADIX];
+    memset(low, 0, sizeof(low));
+    memset(high, 0, sizeof(high));
+
+    const uint16_t* keys = sort->keys;
+
+    for (int i = 0; i < count; i++) {
+        low[keys[i] & 0xFF]++;
+        high[keys[i] >> 8]++;
+    }
+
+    int lowSkip = count == 0 || low[keys[0] & 0xFF] == count;
+    int highSkip = count == 0 || high[keys[0] >> 8] == count;
+
+    // Turn the histograms into the first output position of every digit
+    int lowOffset = 0, highOffset = 0;
+    for (int digit = 0; digit < DEPTH_SORT_RADIX; digit++) {
+        int lowCount = low[digit];
+        int highCount = high[digit];
+        low[digit] = lowOffset;
+        high[digit] = highOffset;
+        lowOffset += lowCount;
+        highOffset += highCount;
+    }
+
+    int* first = highSkip ? sort->order : sort->scratch;
+
+    if (lowSkip) {
+        for (int i = 0; i < count; i++)
+            first[i] = i;
+    } else {
+        for (int i = 0; i < count; i++)
+            first[low[keys[i] & 0xFF]++] = i;
+    }
+
+    if (!highSkip) {
+        for (int i = 0; i < count; i++) {
+            int item = first[i];
+            sort->order[high[keys[item] >> 8]++] = item;
+        }
+    }
+
+    return sort->order;
+}
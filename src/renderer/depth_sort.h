@@ -0,0 +1,31 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#ifndef INC_3D_DEPTH_SORT_H
+#define INC_3D_DEPTH_SORT_H
+
+#include <stdint.h>
+#include "arena.h"
+
+/**
+ * Buffers sorting items by a 16-bit depth key with a two pass radix sort, taken from a frame arena.
+ */
+typedef struct {
+    int capacity;
+    uint16_t* keys;     // Key of every item, filled by the caller
+    int* order;         // Item indices in ascending key order
+    int* scratch;       // Order after the first pass
+} DepthSort;
+
+void depth_sort_init(DepthSort* sort);
+
+int depth_sort_alloc(DepthSort* sort, Arena* arena, int count);
+
+size_t depth_sort_arena_size(int count);
+
+uint16_t depth_sort_key(float depth, float near, float far);
+
+const int* depth_sort_order(DepthSort* sort, int count);
+
+#endif //INC_3D_DEPTH_SORT_H
@@ -0,0 +1,124 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#include <stdlib.h>
+#include <string.h>
+#include "dirty_region.h"
+#include "memory.h"
+#include "pd_api.h"
+
+/**
+ * @brief Allocates the row spans of a region and marks the whole frame as dirty.
+ *
+ * @param region The region to initialize.
+ * @param rows Number of frame rows.
+ * @param columns Number of frame columns in pixels.
+ */
+
+void dirty_region_init(DirtyRegion* region, int rows, int columns) {
+    region->rows = rows;
+    region->rowBytes = (columns + 7) / 8;
+    region->firstByte = memory_alloc(rows);
+    region->lastByte = memory_alloc(rows);
+    dirty_region_fill(region);
+}
+
+void dirty_region_destroy(DirtyRegion* region) {
+    memory_free(region->firstByte);
+    memory_free(region->lastByte);
+    region->firstByte = NULL;
+    region->lastByte = NULL;
+    region->rows = 0;
+}
+
+/**
+ * @brief Marks every row of the region as untouched.
+ */
+
+void dirty_region_reset(DirtyRegion* region) {
+    memset(region->firstByte, 0xFF, region->rows);
+    memset(region->lastByte, 0, region->rows);
+}
+
+/**
+ * @brief Marks the whole frame as touched, used when the frame content is unknown.
+ */
+
+void dirty_region_fill(DirtyRegion* region) {
+    memset(region->firstByte, 0, region->rows);
+    memset(region->lastByte, region->rowBytes - 1, region->rows);
+}
+
+/**
+ * @brief Adds a pixel rectangle to the region. The rectangle is clipped to the frame.
+ *
+ * @param region The region to extend.
+ * @param x0 Left-most pixel column.
+ * @param y0 Top-most pixel row.
+ * @param x1 Right-most pixel column, inclusive.
+ * @param y1 Bottom-most pixel row, inclusive.
+ */
+
+void dirty_region_add_rect(DirtyRegion* region, int x0, int y0, int x1, int y1) {
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 > region->rowBytes * 8 - 1) x1 = region->rowBytes * 8 - 1;
+    if (y1 > region->rows - 1) y1 = region->rows - 1;
+
+    if (x0 > x1 || y0 > y1)
+        return;
+
+    uint8_t first = (uint8_t) (x0 / 8);
+    uint8_t last = (uint8_t) (x1 / 8);
+
+    for (int row = y0; row <= y1; row++) {
+        if (first < region->firstByte[row])
+            region->firstByte[row] = first;
+        if (last > region->lastByte[row])
+            region->lastByte[row] = last;
+    }
+}
+
+/**
+ * @brief Clears the touched spans of the region to white.
+ *
+ * @param region The region to clear.
+ * @param frame Pointer to the frame buffer.
+ */
+
+void dirty_region_clear_frame(const DirtyRegion* region, uint8_t* frame) {
+    for (int row = 0; row < region->rows; row++, frame += LCD_ROWSIZE) {
+        int first = region->firstByte[row];
+        int last = region->lastByte[row];
+
+        if (first <= last)
+            memset(frame + first, 0xFF, last - first + 1);
+    }
+}
+
+/**
+ * @brief Reports every run of rows touched by either region as updated.
+ *
+ * @param a The first region, usually the previous frame.
+ * @param b The second region, usually the current frame.
+ * @param markUpdatedRows Callback receiving the first and last row of each run.
+ */
+
+void dirty_region_mark_rows(const DirtyRegion* a, const DirtyRegion* b, void (* markUpdatedRows)(int start, int end)) {
+    int runStart = -1;
+
+    for (int row = 0; row < a->rows; row++) {
+        int touched = a->firstByte[row] <= a->lastByte[row] || b->firstByte[row] <= b->lastByte[row];
+
+        if (touched && runStart < 0) {
+            runStart = row;
+        } else if (!touched && runStart >= 0) {
+            markUpdatedRows(runStart, row - 1);
+            runStart = -1;
+        }
+    }
+
+    if (runStart >= 0)
+        markUpdatedRows(runStart, a->rows - 1);
+}
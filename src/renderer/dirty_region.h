@@ -0,0 +1,34 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#ifndef INC_3D_DIRTY_REGION_H
+#define INC_3D_DIRTY_REGION_H
+
+#include <stdint.h>
+
+/**
+ * Per-row byte spans of a frame that were drawn to. A row with firstByte > lastByte is untouched.
+ */
+typedef struct {
+    int rows;
+    int rowBytes;
+    uint8_t* firstByte;
+    uint8_t* lastByte;
+} DirtyRegion;
+
+void dirty_region_init(DirtyRegion* region, int rows, int columns);
+
+void dirty_region_destroy(DirtyRegion* region);
+
+void dirty_region_reset(DirtyRegion* region);
+
+void dirty_region_fill(DirtyRegion* region);
+
+void dirty_region_add_rect(DirtyRegion* region, int x0, int y0, int x1, int y1);
+
+void dirty_region_clear_frame(const DirtyRegion* region, uint8_t* frame);
+
+void dirty_region_mark_rows(const DirtyRegion* a, const DirtyRegion* b, void (* markUpdatedRows)(int start, int end));
+
+#endif //INC_3D_DIRTY_REGION_H
@@ -0,0 +1,144 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#include <stdlib.h>
+#include "dither.h"
+#include "memory.h"
+#include "bayer.h"
+
+static int is_power_of_two(int value) {
+    return value > 0 && (value & (value - 1)) == 0;
+}
+
+/**
+ * @brief Creates the packed patterns of an ordered dither threshold map.
+ *
+ * For every brightness level and every row of the map the thresholds are compared once and packed into
+ * bytes, 8 pixels per byte. Maps narrower than 8 pixels are repeated within the byte, wider maps store
+ * width / 8 bytes per row. A pixel of level l is on when threshold * (levels - 1) < l * range, which for a
+ * Bayer map with levels = range + 1 simply reads threshold < l.
+ *
+ * @param thresholds Row-major threshold map with values in [0, range).
+ * @param width Width of the map, must be a power of two.
+ * @param height Height of the map, must be a power of two.
+ * @param range Exclusive upper bound of the threshold values.
+ * @param levels Number of brightness levels to precompute, at least 2.
+ * @return The dither table, or NULL if the parameters are invalid or it doesn't fit the heap.
+ */
+
+DitherTable* dither_create(const int* thresholds, int width, int height, int range, int levels) {
+    if (thresholds == NULL || !is_power_of_two(width) || !is_power_of_two(height) || range <= 0 || levels < 2)
+        return NULL;
+
+    int rowBytes = width < 8 ? 1 : width / 8;
+
+    DitherTable* table = memory_alloc(sizeof(DitherTable));
+    if (table == NULL)
+        return NULL;
+
+    table->width = width;
+    table->height = height;
+    table->rowBytes = rowBytes;
+    table->levels = levels;
+    table->patterns = memory_alloc((size_t) levels * height * rowBytes);
+
+    if (table->patterns == NULL) {
+        memory_free(table);
+        return NULL;
+    }
+
+    uint8_t* pattern = table->patterns;
+
+    for (int level = 0; level < levels; level++) {
+        for (int row = 0; row < height; row++) {
+            for (int byte = 0; byte < rowBytes; byte++, pattern++) {
+                *pattern = 0;
+
+                for (int bit = 0; bit < 8; bit++) {
+                    int column = (byte * 8 + bit) % width;
+                    int threshold = thresholds[row * width + column];
+
+                    if (threshold * (levels - 1) < level * range)
+                        *pattern |= 1 << (7 - bit);
+                }
+            }
+        }
+    }
+
+    return table;
+}
+
+/**
+ * @brief Creates the packed patterns of one of the built-in Bayer matrices.
+ *
+ * @param bayerSize The size of the Bayer matrix. BAYER_2, BAYER_4, or BAYER_8.
+ * @return The dither table, or NULL for an unknown size.
+ */
+
+DitherTable* dither_create_bayer(int bayerSize) {
+    if (bayerSize != BAYER_2 && bayerSize != BAYER_4 && bayerSize != BAYER_8)
+        return NULL;
+
+    int thresholds[BAYER_8 * BAYER_8];
+
+    for (int row = 0; row < bayerSize; row++)
+        for (int column = 0; column < bayerSize; column++)
+            thresholds[row * bayerSize + column] = bayer_value(row, column, bayerSize);
+
+    int range = bayerSize * bayerSize;
+    return dither_create(thresholds, bayerSize, bayerSize, range, range + 1);
+}
+
+void dither_destroy(DitherTable* table) {
+    if (table == NULL)
+        return;
+
+    memory_free(table->patterns);
+    memory_free(table);
+}
+
+/**
+ * @brief Returns the pattern closest to a brightness.
+ *
+ * @param table The dither table.
+ * @param brightness Brightness between 0 and 1, values outside are clamped.
+ * @return The pattern of the brightness level.
+ */
+
+DitherPattern dither_pattern(const DitherTable* table, float brightness) {
+    int level = (int) (brightness * (float) (table->levels - 1));
+
+    if (level < 0)
+        level = 0;
+    if (level > table->levels - 1)
+        level = table->levels - 1;
+
+    DitherPattern pattern = {
+            .rows = table->patterns + (size_t) level * table->height * table->rowBytes,
+            .rowMask = table->height - 1,
+            .rowBytes = table->rowBytes,
+            .byteMask = table->rowBytes - 1,
+            .door = NULL,
+            .doorFlip = 0
+    };
+    return pattern;
+}
+
+/**
+ * @brief Restricts a fill to a share of the pixels, for cross-fading two overlapping surfaces.
+ *
+ * The door is the pattern of the share as brightness, so two fills with the same share, one of them inverted,
+ * write complementary pixels. As the door and the fill come from the same threshold map, two surfaces of the
+ * same brightness together look exactly like one.
+ *
+ * @param pattern The pattern of the fill.
+ * @param table The table the pattern was taken from.
+ * @param share Share of the pixels written, 0 to 1.
+ * @param invert Write the pixels a fill with the same share leaves out instead.
+ */
+
+void dither_set_door(DitherPattern* pattern, const DitherTable* table, float share, int invert) {
+    pattern->door = dither_pattern(table, share).rows;
+    pattern->doorFlip = invert ? 0xFF : 0x00;
+}
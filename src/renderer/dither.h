@@ -0,0 +1,64 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#ifndef INC_3D_DITHER_H
+#define INC_3D_DITHER_H
+
+#include <stdint.h>
+
+/**
+ * Packed 1-bit patterns of a threshold map, precomputed for every brightness level and row phase.
+ * A pattern row holds one bit per pixel of a frame row, so filling becomes a masked byte copy.
+ */
+typedef struct {
+    int width;      // Width of the threshold map in pixels
+    int height;     // Height of the threshold map in pixels
+    int rowBytes;   // Pattern bytes stored per row
+    int levels;     // Number of brightness levels
+    uint8_t* patterns;  // levels * height * rowBytes pattern bytes
+} DitherTable;
+
+/**
+ * The pattern of a single brightness level.
+ */
+typedef struct {
+    const uint8_t* rows;  // height * rowBytes pattern bytes
+    int rowMask;    // Mask turning a frame row into a pattern row
+    int rowBytes;   // Pattern bytes per row
+    int byteMask;   // Mask turning a frame byte column into a pattern byte column
+
+    // Screen door of a fill, only the pixels set in door ^ doorFlip are written. NULL writes every pixel.
+    const uint8_t* door;
+    uint8_t doorFlip;
+} DitherPattern;
+
+DitherTable* dither_create(const int* thresholds, int width, int height, int range, int levels);
+
+DitherTable* dither_create_bayer(int bayerSize);
+
+void dither_destroy(DitherTable* table);
+
+DitherPattern dither_pattern(const DitherTable* table, float brightness);
+
+void dither_set_door(DitherPattern* pattern, const DitherTable* table, float share, int invert);
+
+/**
+ * Returns the pattern bytes of a frame row.
+ *
+ * @param pattern The pattern of the brightness level.
+ * @param rowIndex The frame row.
+ * @return Pointer to the pattern row, index it with (byteIndex & pattern->byteMask).
+ */
+static inline const uint8_t* dither_pattern_row(const DitherPattern* pattern, int rowIndex) {
+    return pattern->rows + (rowIndex & pattern->rowMask) * pattern->rowBytes;
+}
+
+/**
+ * Returns the door bytes of a frame row, like dither_pattern_row. The pattern must have a door.
+ */
+static inline const uint8_t* dither_door_row(const DitherPattern* pattern, int rowIndex) {
+    return pattern->door + (rowIndex & pattern->rowMask) * pattern->rowBytes;
+}
+
+#endif //INC_3D_DITHER_H
@@ -0,0 +1,342 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "frame_cache.h"
+#include "memory.h"
+#include "pd_api.h"
+
+// Longest zero run and longest literal of a single control byte
+#define FRAME_CACHE_MAX_RUN 128
+
+static void frame_cache_unlink(FrameCache* cache, FrameCacheEntry* entry);
+
+static void frame_cache_push_newest(FrameCache* cache, FrameCacheEntry* entry);
+
+static void frame_cache_evict(FrameCache* cache, FrameCacheEntry* entry);
+
+static int frame_cache_page_count(int size);
+
+static int frame_cache_encode(const uint8_t* in, int length, uint8_t* out);
+
+static void frame_cache_decode_runs(const uint8_t* in, int size, uint8_t* out);
+
+/**
+ * @brief Initializes an empty frame cache.
+ *
+ * @param cache The cache to initialize.
+ * @param rows Number of frame rows to cache.
+ * @param columns Number of frame columns to cache in pixels.
+ * @param step Degrees between two keys, angles in between share the key below them.
+ * @param budget Bytes the cached frames may use, taken at once as pages of FRAME_CACHE_PAGE_SIZE bytes.
+ * Without the memory for it every lookup misses and nothing is stored.
+ */
+
+void frame_cache_init(FrameCache* cache, int rows, int columns, float step, int budget) {
+    cache->rows = rows;
+    cache->rowBytes = (columns + 7) / 8;
+    cache->step = step;
+    cache->keyCount = (int) ceilf(360.0f / step);
+    cache->budget = budget;
+    cache->bytesUsed = 0;
+    cache->hits = 0;
+    cache->misses = 0;
+    cache->entries = memory_calloc(cache->keyCount, sizeof(FrameCacheEntry));
+    cache->newest = NULL;
+    cache->oldest = NULL;
+
+    int length = rows * cache->rowBytes;
+    cache->delta = memory_alloc(length);
+    cache->encoded = memory_alloc(length + (length + FRAME_CACHE_MAX_RUN - 1) / FRAME_CACHE_MAX_RUN);
+
+    int pageCount = budget / (int) sizeof(FrameCachePage);
+    cache->pages = memory_alloc(sizeof(FrameCachePage) * pageCount);
+    cache->freePages = NULL;
+    cache->freePageCount = pageCount;
+
+    if (cache->entries == NULL || cache->delta == NULL || cache->encoded == NULL || (pageCount > 0 && cache->pages == NULL)) {
+        frame_cache_destroy(cache);
+        return;
+    }
+
+    for (int i = pageCount - 1; i >= 0; i--) {
+        cache->pages[i].next = cache->freePages;
+        cache->freePages = &cache->pages[i];
+    }
+}
+
+void frame_cache_destroy(FrameCache* cache) {
+    frame_cache_clear(cache);
+    memory_free(cache->entries);
+    memory_free(cache->delta);
+    memory_free(cache->encoded);
+    memory_free(cache->pages);
+    cache->entries = NULL;
+    cache->delta = NULL;
+    cache->encoded = NULL;
+    cache->pages = NULL;
+    cache->freePages = NULL;
+    cache->freePageCount = 0;
+}
+
+/**
+ * @brief Drops every cached frame, needed whenever something else than the angle changes the image.
+ */
+
+void frame_cache_clear(FrameCache* cache) {
+    while (cache->oldest != NULL)
+        frame_cache_evict(cache, cache->oldest);
+}
+
+/**
+ * @brief Quantizes an angle in degrees to the key of its frame.
+ */
+
+int frame_cache_key(const FrameCache* cache, float angle) {
+    int key = (int) floorf(angle / cache->step);
+    key %= cache->keyCount;
+    return key < 0 ? key + cache->keyCount : key;
+}
+
+/**
+ * @brief Returns the angle in degrees a key stands for. Frames are rendered at this angle, so every frame
+ * of a key is the same.
+ */
+
+float frame_cache_angle(const FrameCache* cache, int key) {
+    return (float) key * cache->step;
+}
+
+/**
+ * @brief Looks up the frame of a key and marks it as the most recently used.
+ *
+ * @param cache The cache.
+ * @param key The key of the frame.
+ * @return The cached frame, NULL on a miss.
+ */
+
+const FrameCacheEntry* frame_cache_find(FrameCache* cache, int key) {
+    FrameCacheEntry* entry = cache->entries != NULL ? &cache->entries[key] : NULL;
+
+    if (entry == NULL || entry->pages == NULL) {
+        cache->misses++;
+        return NULL;
+    }
+
+    cache->hits++;
+    frame_cache_unlink(cache, entry);
+    frame_cache_push_newest(cache, entry);
+
+    return entry;
+}
+
+/**
+ * @brief Compresses a frame and stores it under a key, evicting the least recently used frames over budget.
+ *
+ * Each row is XORed with the row FRAME_CACHE_DELTA_ROWS above, the first rows with the white background,
+ * so blank and evenly dithered areas turn into zeros. The result is coded as runs of zeros and literals.
+ *
+ * @param cache The cache.
+ * @param key The key of the frame.
+ * @param frame Pointer to the frame buffer.
+ */
+
+void frame_cache_store(FrameCache* cache, int key, const uint8_t* frame) {
+    if (cache->entries == NULL)
+        return;
+
+    FrameCacheEntry* entry = &cache->entries[key];
+    if (entry->pages != NULL)
+        frame_cache_evict(cache, entry);
+
+    uint8_t* delta = cache->delta;
+    for (int row = 0; row < cache->rows; row++, frame += LCD_ROWSIZE, delta += cache->rowBytes) {
+        const uint8_t* reference = row >= FRAME_CACHE_DELTA_ROWS ? frame - FRAME_CACHE_DELTA_ROWS * LCD_ROWSIZE : NULL;
+
+        for (int i = 0; i < cache->rowBytes; i++)
+            delta[i] = frame[i] ^ (reference != NULL ? reference[i] : 0xFF);
+    }
+
+    int size = frame_cache_encode(cache->delta, cache->rows * cache->rowBytes, cache->encoded);
+    int pageCount = frame_cache_page_count(size);
+    if (pageCount > cache->budget / (int) sizeof(FrameCachePage))
+        return;
+
+    while (cache->freePageCount < pageCount)
+        frame_cache_evict(cache, cache->oldest);
+
+    // Pages are chained in the order of the data
+    FrameCachePage** link = &entry->pages;
+    for (int offset = 0; offset < size; offset += FRAME_CACHE_PAGE_SIZE) {
+        FrameCachePage* page = cache->freePages;
+        cache->freePages = page->next;
+
+        int count = size - offset < FRAME_CACHE_PAGE_SIZE ? size - offset : FRAME_CACHE_PAGE_SIZE;
+        memcpy(page->data, cache->encoded + offset, count);
+
+        *link = page;
+        link = &page->next;
+    }
+    *link = NULL;
+
+    entry->key = key;
+    entry->size = size;
+    cache->freePageCount -= pageCount;
+    cache->bytesUsed += pageCount * (int) sizeof(FrameCachePage);
+    frame_cache_push_newest(cache, entry);
+}
+
+/**
+ * @brief Decompresses a cached frame into the frame buffer.
+ *
+ * Every cached row is overwritten, so the frame doesn't need to be cleared first.
+ *
+ * @param cache The cache.
+ * @param entry The cached frame.
+ * @param frame Pointer to the frame buffer.
+ * @param drawn Reset and extended by the spans of every row that isn't blank.
+ */
+
+void frame_cache_decode(FrameCache* cache, const FrameCacheEntry* entry, uint8_t* frame, DirtyRegion* drawn) {
+    // Runs may cross pages, the pages are joined first
+    int offset = 0;
+    for (const FrameCachePage* page = entry->pages; page != NULL; page = page->next, offset += FRAME_CACHE_PAGE_SIZE) {
+        int count = entry->size - offset < FRAME_CACHE_PAGE_SIZE ? entry->size - offset : FRAME_CACHE_PAGE_SIZE;
+        memcpy(cache->encoded + offset, page->data, count);
+    }
+
+    frame_cache_decode_runs(cache->encoded, entry->size, cache->delta);
+    dirty_region_reset(drawn);
+
+    const uint8_t* delta = cache->delta;
+    for (int row = 0; row < cache->rows; row++, frame += LCD_ROWSIZE, delta += cache->rowBytes) {
+        const uint8_t* reference = row >= FRAME_CACHE_DELTA_ROWS ? frame - FRAME_CACHE_DELTA_ROWS * LCD_ROWSIZE : NULL;
+        int first = -1, last = -1;
+
+        for (int i = 0; i < cache->rowBytes; i++) {
+            frame[i] = delta[i] ^ (reference != NULL ? reference[i] : 0xFF);
+
+            if (frame[i] != 0xFF) {
+                if (first < 0)
+                    first = i;
+                last = i;
+            }
+        }
+
+        if (first >= 0)
+            dirty_region_add_rect(drawn, first * 8, row, last * 8 + 7, row);
+    }
+}
+
+/**
+ * @brief Returns the share of lookups that found their frame, 0 before the first lookup.
+ */
+
+float frame_cache_hit_rate(const FrameCache* cache) {
+    int lookups = cache->hits + cache->misses;
+    return lookups > 0 ? (float) cache->hits / (float) lookups : 0.0f;
+}
+
+static void frame_cache_unlink(FrameCache* cache, FrameCacheEntry* entry) {
+    if (entry->newer != NULL)
+        entry->newer->older = entry->older;
+    else
+        cache->newest = entry->older;
+
+    if (entry->older != NULL)
+        entry->older->newer = entry->newer;
+    else
+        cache->oldest = entry->newer;
+}
+
+static void frame_cache_push_newest(FrameCache* cache, FrameCacheEntry* entry) {
+    entry->newer = NULL;
+    entry->older = cache->newest;
+
+    if (cache->newest != NULL)
+        cache->newest->newer = entry;
+    else
+        cache->oldest = entry;
+
+    cache->newest = entry;
+}
+
+static void frame_cache_evict(FrameCache* cache, FrameCacheEntry* entry) {
+    frame_cache_unlink(cache, entry);
+
+    // The chain goes back to the front of the free list as it is
+    FrameCachePage* last = entry->pages;
+    while (last->next != NULL)
+        last = last->next;
+
+    int pageCount = frame_cache_page_count(entry->size);
+    last->next = cache->freePages;
+    cache->freePages = entry->pages;
+    cache->freePageCount += pageCount;
+    cache->bytesUsed -= pageCount * (int) sizeof(FrameCachePage);
+    entry->pages = NULL;
+}
+
+static int frame_cache_page_count(int size) {
+    return (size + FRAME_CACHE_PAGE_SIZE - 1) / FRAME_CACHE_PAGE_SIZE;
+}
+
+/**
+ * @brief Codes bytes as runs of zeros and literals.
+ *
+ * A control byte below FRAME_CACHE_MAX_RUN stands for control + 1 zeros, any other control byte is followed by
+ * control - FRAME_CACHE_MAX_RUN + 1 literal bytes. Single zeros stay inside a literal, ending it would cost more.
+ *
+ * @param in The bytes to code.
+ * @param length Number of bytes.
+ * @param out Receives the coded bytes, length + ceil(length / FRAME_CACHE_MAX_RUN) bytes at most.
+ * @return Number of coded bytes.
+ */
+
+static int frame_cache_encode(const uint8_t* in, int length, uint8_t* out) {
+    int size = 0;
+    int i = 0;
+
+    while (i < length) {
+        int run = 0;
+        while (i + run < length && run < FRAME_CACHE_MAX_RUN && in[i + run] == 0)
+            run++;
+
+        if (run > 0) {
+            out[size++] = (uint8_t) (run - 1);
+            i += run;
+            continue;
+        }
+
+        int start = i;
+        while (i < length && i - start < FRAME_CACHE_MAX_RUN && (in[i] != 0 || (i + 1 < length && in[i + 1] != 0)))
+            i++;
+
+        out[size++] = (uint8_t) (FRAME_CACHE_MAX_RUN + i - start - 1);
+        memcpy(out + size, in + start, i - start);
+        size += i - start;
+    }
+
+    return size;
+}
+
+static void frame_cache_decode_runs(const uint8_t* in, int size, uint8_t* out) {
+    const uint8_t* end = in + size;
+
+    while (in < end) {
+        int control = *in++;
+
+        if (control < FRAME_CACHE_MAX_RUN) {
+            memset(out, 0, control + 1);
+            out += control + 1;
+        } else {
+            int count = control - FRAME_CACHE_MAX_RUN + 1;
+            memcpy(out, in, count);
+            in += count;
+            out += count;
+        }
+    }
+}
@@ -0,0 +1,73 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#ifndef INC_3D_FRAME_CACHE_H
+#define INC_3D_FRAME_CACHE_H
+
+#include <stdint.h>
+#include "dirty_region.h"
+
+// Rows between a frame row and the row it is delta coded against. Every Bayer pattern repeats after 8 rows,
+// so dithered fills cancel out and only their edges are left.
+#define FRAME_CACHE_DELTA_ROWS 8
+
+// Bytes of encoded data per page, an entry wastes less than one page
+#define FRAME_CACHE_PAGE_SIZE 256
+
+typedef struct FrameCachePage {
+    struct FrameCachePage* next;
+    uint8_t data[FRAME_CACHE_PAGE_SIZE];
+} FrameCachePage;
+
+typedef struct FrameCacheEntry {
+    int key;
+    int size;                       // Bytes of encoded data
+    struct FrameCacheEntry* newer;  // Toward the most recently used entry
+    struct FrameCacheEntry* older;  // Toward the least recently used entry
+    FrameCachePage* pages;          // Encoded data in order, NULL when the key isn't cached
+} FrameCacheEntry;
+
+/**
+ * Rendered frames keyed by a quantized angle, compressed and kept as long as they fit into a memory budget.
+ * The least recently used frames are evicted first. The budget is allocated once as pages, so storing a frame
+ * never touches the heap.
+ */
+typedef struct {
+    int rows;
+    int rowBytes;
+    float step;         // Degrees per key
+    int keyCount;
+    int budget;         // Bytes the entries may use
+    int bytesUsed;
+    int hits;
+    int misses;
+    FrameCacheEntry* entries;   // By key
+    FrameCacheEntry* newest;
+    FrameCacheEntry* oldest;
+    uint8_t* delta;     // Scratch for one delta coded frame
+    uint8_t* encoded;   // Scratch for one encoded frame, large enough for the worst case
+    FrameCachePage* pages;      // The whole budget, taken in init
+    FrameCachePage* freePages;
+    int freePageCount;
+} FrameCache;
+
+void frame_cache_init(FrameCache* cache, int rows, int columns, float step, int budget);
+
+void frame_cache_destroy(FrameCache* cache);
+
+void frame_cache_clear(FrameCache* cache);
+
+int frame_cache_key(const FrameCache* cache, float angle);
+
+float frame_cache_angle(const FrameCache* cache, int key);
+
+const FrameCacheEntry* frame_cache_find(FrameCache* cache, int key);
+
+void frame_cache_store(FrameCache* cache, int key, const uint8_t* frame);
+
+void frame_cache_decode(FrameCache* cache, const FrameCacheEntry* entry, uint8_t* frame, DirtyRegion* drawn);
+
+float frame_cache_hit_rate(const FrameCache* cache);
+
+#endif //INC_3D_FRAME_CACHE_H
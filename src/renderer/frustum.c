@@ -0,0 +1,85 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#include <math.h>
+#include "frustum.h"
+
+static Vector4 matrix_column(const Matrix4x4* matrix, int column) {
+    Vector4 result = {matrix->m[0][column], matrix->m[1][column], matrix->m[2][column], matrix->m[3][column]};
+    return result;
+}
+
+static Vector4 plane_combine(Vector4 a, Vector4 b, float sign) {
+    Vector4 result = {a.x + sign * b.x, a.y + sign * b.y, a.z + sign * b.z, a.w + sign * b.w};
+    return result;
+}
+
+static Vector4 plane_normalize(Vector4 plane) {
+    float length = sqrtf(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+    if (length > 0.0f) {
+        plane.x /= length;
+        plane.y /= length;
+        plane.z /= length;
+        plane.w /= length;
+    }
+    return plane;
+}
+
+/**
+ * @brief Extracts the frustum planes from a view-projection matrix.
+ *
+ * The side planes follow from -w <= x, y <= w in clip space. The projection stores the view depth in w,
+ * so near and far are taken from w directly instead of from the projected z.
+ *
+ * @param viewProjection The combined view and projection matrix, applied to row vectors.
+ * @param near Distance of the near plane.
+ * @param far Distance of the far plane.
+ * @return The frustum in the space the matrix transforms from.
+ */
+
+Frustum frustum_from_matrix(const Matrix4x4* viewProjection, float near, float far) {
+    Vector4 x = matrix_column(viewProjection, 0);
+    Vector4 y = matrix_column(viewProjection, 1);
+    Vector4 w = matrix_column(viewProjection, 3);
+
+    Vector4 nearPlane = w;
+    nearPlane.w -= near;
+
+    Vector4 farPlane = {-w.x, -w.y, -w.z, far - w.w};
+
+    Frustum frustum = {
+            .planes = {
+                    plane_normalize(plane_combine(w, x, 1.0f)),
+                    plane_normalize(plane_combine(w, x, -1.0f)),
+                    plane_normalize(plane_combine(w, y, 1.0f)),
+                    plane_normalize(plane_combine(w, y, -1.0f)),
+                    plane_normalize(nearPlane),
+                    plane_normalize(farPlane)
+            }
+    };
+    return frustum;
+}
+
+/**
+ * @brief Tests whether a sphere is at least partially inside the frustum.
+ *
+ * @param frustum The frustum.
+ * @param sphere The sphere, in the same space as the frustum.
+ * @return 1 if the sphere may be visible, 0 if it is fully outside one of the planes.
+ */
+
+int frustum_contains_sphere(const Frustum* frustum, const BoundingSphere* sphere) {
+    if (sphere->radius < 0.0f)
+        return 0;
+
+    for (int i = 0; i < 6; i++) {
+        const Vector4* plane = &frustum->planes[i];
+        float distance = plane->x * sphere->center.x + plane->y * sphere->center.y + plane->z * sphere->center.z + plane->w;
+
+        if (distance < -sphere->radius)
+            return 0;
+    }
+
+    return 1;
+}
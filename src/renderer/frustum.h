@@ -0,0 +1,22 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#ifndef INC_3D_FRUSTUM_H
+#define INC_3D_FRUSTUM_H
+
+#include "bounds.h"
+
+/**
+ * View frustum as six planes (a, b, c, d) with unit normals pointing inwards, a point p is inside
+ * a plane when a * p.x + b * p.y + c * p.z + d >= 0.
+ */
+typedef struct {
+    Vector4 planes[6];
+} Frustum;
+
+Frustum frustum_from_matrix(const Matrix4x4* viewProjection, float near, float far);
+
+int frustum_contains_sphere(const Frustum* frustum, const BoundingSphere* sphere);
+
+#endif //INC_3D_FRUSTUM_H
@@ -0,0 +1,280 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#include <math.h>
+#include "matrix4x3.h"
+
+Matrix4x3 matrix4x3_identity(void) {
+    Matrix4x3 result = {
+            .m = {
+                    {1.0f, 0.0f, 0.0f},
+                    {0.0f, 1.0f, 0.0f},
+                    {0.0f, 0.0f, 1.0f},
+                    {0.0f, 0.0f, 0.0f}
+            }
+    };
+    return result;
+}
+
+Matrix4x3 matrix4x3_translation(Vector3 translation) {
+    Matrix4x3 result = matrix4x3_identity();
+    result.m[3][0] = translation.x;
+    result.m[3][1] = translation.y;
+    result.m[3][2] = translation.z;
+    return result;
+}
+
+/**
+ * @brief Builds the rotation around X, then Z, then Y in closed form.
+ *
+ * Equal to the product of the three single-axis rotations (matrix4x4_rotate_y for Y), but evaluates every
+ * sine and cosine once and skips the matrix products.
+ *
+ * @param rotation The rotation angles around each axis in radians.
+ * @return The rotation matrix.
+ */
+
+Matrix4x3 matrix4x3_euler(Vector3 rotation) {
+    float sx = sinf(rotation.x), cx = cosf(rotation.x);
+    float sy = sinf(rotation.y), cy = cosf(rotation.y);
+    float sz = sinf(rotation.z), cz = cosf(rotation.z);
+
+    Matrix4x3 result = {
+            .m = {
+                    {cz * cy,                -sz,     cz * sy},
+                    {cx * sz * cy + sx * sy, cx * cz, cx * sz * sy - sx * cy},
+                    {sx * sz * cy - cx * sy, sx * cz, sx * sz * sy + cx * cy},
+                    {0.0f,                   0.0f,    0.0f}
+            }
+    };
+    return result;
+}
+
+/**
+ * @brief Builds a rotation around an arbitrary axis.
+ *
+ * Rotates in the same direction as the Euler builder, a rotation around (1, 0, 0) matches an Euler rotation
+ * around X by the same angle.
+ *
+ * @param axis The rotation axis, must be normalized.
+ * @param angle The rotation angle in radians.
+ * @return The rotation matrix.
+ */
+
+Matrix4x3 matrix4x3_axis_angle(Vector3 axis, float angle) {
+    float s = sinf(angle);
+    float c = cosf(angle);
+    float t = 1.0f - c;
+
+    float x = axis.x, y = axis.y, z = axis.z;
+
+    Matrix4x3 result = {
+            .m = {
+                    {t * x * x + c,     t * x * y - s * z, t * x * z + s * y},
+                    {t * x * y + s * z, t * y * y + c,     t * y * z - s * x},
+                    {t * x * z - s * y, t * y * z + s * x, t * z * z + c},
+                    {0.0f,              0.0f,              0.0f}
+            }
+    };
+    return result;
+}
+
+/**
+ * @brief Builds the transformation that scales, rotates and then translates a point.
+ *
+ * @param position The translation.
+ * @param rotation The Euler angles in radians, see matrix4x3_euler.
+ * @param scale The scale along each axis.
+ * @return The combined transformation.
+ */
+
+Matrix4x3 matrix4x3_transform(Vector3 position, Vector3 rotation, Vector3 scale) {
+    Matrix4x3 result = matrix4x3_euler(rotation);
+
+    // Scaling first only scales the rows of the rotation
+    for (int column = 0; column < 3; column++) {
+        result.m[0][column] *= scale.x;
+        result.m[1][column] *= scale.y;
+        result.m[2][column] *= scale.z;
+    }
+
+    result.m[3][0] = position.x;
+    result.m[3][1] = position.y;
+    result.m[3][2] = position.z;
+
+    return result;
+}
+
+Matrix4x4 matrix4x3_to_matrix4x4(const Matrix4x3* matrix) {
+    Matrix4x4 result = {0};
+
+    for (int row = 0; row < 4; row++)
+        for (int column = 0; column < 3; column++)
+            result.m[row][column] = matrix->m[row][column];
+
+    result.m[3][3] = 1.0f;
+    return result;
+}
+
+/**
+ * @brief Combines two affine transformations, the result applies a first and b second.
+ *
+ * Needs 36 multiplications instead of the 64 of matrix4x4_multiply, the constant last column is never touched.
+ *
+ * @param a The first transformation.
+ * @param b The second transformation.
+ * @param result The combined transformation, may alias a or b.
+ */
+
+void matrix4x3_multiply(const Matrix4x3* a, const Matrix4x3* b, Matrix4x3* result) {
+    Matrix4x3 temp;
+
+    for (int row = 0; row < 4; row++) {
+        for (int column = 0; column < 3; column++) {
+            temp.m[row][column] = a->m[row][0] * b->m[0][column] +
+                                  a->m[row][1] * b->m[1][column] +
+                                  a->m[row][2] * b->m[2][column];
+        }
+    }
+
+    temp.m[3][0] += b->m[3][0];
+    temp.m[3][1] += b->m[3][1];
+    temp.m[3][2] += b->m[3][2];
+
+    *result = temp;
+}
+
+/**
+ * @brief Calculates the matrix transforming normals of surfaces transformed by the given matrix.
+ *
+ * Normals transform by the inverse transpose of the linear part, which is proportional to its cofactor
+ * matrix, so no inverse is needed. When the matrix only rotates and scales uniformly the result is also
+ * rescaled to keep unit normals at unit length, otherwise the caller has to normalize transformed normals.
+ *
+ * @param matrix The affine transformation.
+ * @param result The normal matrix, its translation is zero.
+ * @return 1 if the normal matrix keeps the length of normals, 0 if transformed normals need normalizing.
+ */
+
+int matrix4x3_normal_matrix(const Matrix4x3* matrix, Matrix4x3* result) {
+    const float (*m)[3] = matrix->m;
+
+    Matrix4x3 cofactor = {
+            .m = {
+                    {m[1][1] * m[2][2] - m[1][2] * m[2][1], m[1][2] * m[2][0] - m[1][0] * m[2][2], m[1][0] * m[2][1] - m[1][1] * m[2][0]},
+                    {m[2][1] * m[0][2] - m[2][2] * m[0][1], m[2][2] * m[0][0] - m[2][0] * m[0][2], m[2][0] * m[0][1] - m[2][1] * m[0][0]},
+                    {m[0][1] * m[1][2] - m[0][2] * m[1][1], m[0][2] * m[1][0] - m[0][0] * m[1][2], m[0][0] * m[1][1] - m[0][1] * m[1][0]},
+                    {0.0f,                                  0.0f,                                  0.0f}
+            }
+    };
+
+    Vector3 axes[3];
+    for (int row = 0; row < 3; row++)
+        axes[row] = (Vector3) {cofactor.m[row][0], cofactor.m[row][1], cofactor.m[row][2]};
+
+    float lengths[3] = {
+            vector3_squared_length(axes[0]),
+            vector3_squared_length(axes[1]),
+            vector3_squared_length(axes[2])
+    };
+
+    // Mirroring transformations flip the cofactors, keep the normals pointing outwards
+    float determinant = m[0][0] * cofactor.m[0][0] + m[0][1] * cofactor.m[0][1] + m[0][2] * cofactor.m[0][2];
+    float scale = determinant < 0.0f ? -1.0f : 1.0f;
+
+    float tolerance = 0.0001f * lengths[0];
+    int uniform = lengths[0] > 0.0f &&
+                  fabsf(lengths[1] - lengths[0]) <= tolerance &&
+                  fabsf(lengths[2] - lengths[0]) <= tolerance &&
+                  fabsf(vector3_dot_product(axes[0], axes[1])) <= tolerance &&
+                  fabsf(vector3_dot_product(axes[0], axes[2])) <= tolerance &&
+                  fabsf(vector3_dot_product(axes[1], axes[2])) <= tolerance;
+
+    if (uniform)
+        scale /= sqrtf(lengths[0]);
+
+    for (int row = 0; row < 3; row++)
+        for (int column = 0; column < 3; column++)
+            result->m[row][column] = cofactor.m[row][column] * scale;
+
+    result->m[3][0] = 0.0f;
+    result->m[3][1] = 0.0f;
+    result->m[3][2] = 0.0f;
+
+    return uniform;
+}
+
+/**
+ * @brief Inverts an affine transformation.
+ *
+ * @param matrix The transformation to invert.
+ * @param result The inverse, may alias matrix.
+ * @return 1 on success, 0 if the matrix is singular and result was left unchanged.
+ */
+
+int matrix4x3_inverse(const Matrix4x3* matrix, Matrix4x3* result) {
+    const float (*m)[3] = matrix->m;
+
+    // Inverse of the linear part is the transposed cofactor matrix divided by the determinant
+    float c00 = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+    float c01 = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+    float c02 = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+
+    float determinant = m[0][0] * c00 + m[0][1] * c01 + m[0][2] * c02;
+    if (fabsf(determinant) < 1e-12f)
+        return 0;
+
+    float inverse = 1.0f / determinant;
+
+    Matrix4x3 temp;
+    temp.m[0][0] = c00 * inverse;
+    temp.m[1][0] = c01 * inverse;
+    temp.m[2][0] = c02 * inverse;
+    temp.m[0][1] = (m[2][1] * m[0][2] - m[2][2] * m[0][1]) * inverse;
+    temp.m[1][1] = (m[2][2] * m[0][0] - m[2][0] * m[0][2]) * inverse;
+    temp.m[2][1] = (m[2][0] * m[0][1] - m[2][1] * m[0][0]) * inverse;
+    temp.m[0][2] = (m[0][1] * m[1][2] - m[0][2] * m[1][1]) * inverse;
+    temp.m[1][2] = (m[0][2] * m[1][0] - m[0][0] * m[1][2]) * inverse;
+    temp.m[2][2] = (m[0][0] * m[1][1] - m[0][1] * m[1][0]) * inverse;
+
+    // Undo the translation in the original space
+    Vector3 translation = {-m[3][0], -m[3][1], -m[3][2]};
+    Vector3 inverseTranslation;
+    vector3_rotate_matrix4x3(&translation, &inverseTranslation, &temp);
+
+    temp.m[3][0] = inverseTranslation.x;
+    temp.m[3][1] = inverseTranslation.y;
+    temp.m[3][2] = inverseTranslation.z;
+
+    *result = temp;
+    return 1;
+}
+
+/**
+ * @brief Transforms a point, an affine transformation never needs a divide by w.
+ *
+ * @param in The input point.
+ * @param out The transformed point, must not alias in.
+ * @param matrix The transformation.
+ */
+
+void vector3_multiply_matrix4x3(const Vector3* in, Vector3* out, const Matrix4x3* matrix) {
+    out->x = in->x * matrix->m[0][0] + in->y * matrix->m[1][0] + in->z * matrix->m[2][0] + matrix->m[3][0];
+    out->y = in->x * matrix->m[0][1] + in->y * matrix->m[1][1] + in->z * matrix->m[2][1] + matrix->m[3][1];
+    out->z = in->x * matrix->m[0][2] + in->y * matrix->m[1][2] + in->z * matrix->m[2][2] + matrix->m[3][2];
+}
+
+/**
+ * @brief Transforms a direction, ignoring the translation.
+ *
+ * @param in The input direction.
+ * @param out The transformed direction, must not alias in.
+ * @param matrix The transformation.
+ */
+
+void vector3_rotate_matrix4x3(const Vector3* in, Vector3* out, const Matrix4x3* matrix) {
+    out->x = in->x * matrix->m[0][0] + in->y * matrix->m[1][0] + in->z * matrix->m[2][0];
+    out->y = in->x * matrix->m[0][1] + in->y * matrix->m[1][1] + in->z * matrix->m[2][1];
+    out->z = in->x * matrix->m[0][2] + in->y * matrix->m[1][2] + in->z * matrix->m[2][2];
+}
@@ -0,0 +1,40 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#ifndef INC_3D_MATRIX4X3_H
+#define INC_3D_MATRIX4X3_H
+
+#include "matrix4x4.h"
+
+/**
+ * Affine transformation applied to row vectors, like Matrix4x4 without the constant last column (0, 0, 0, 1).
+ * Rows 0 to 2 hold the linear part, row 3 the translation.
+ */
+typedef struct {
+    float m[4][3];
+} Matrix4x3;
+
+Matrix4x3 matrix4x3_identity(void);
+
+Matrix4x3 matrix4x3_translation(Vector3 translation);
+
+Matrix4x3 matrix4x3_euler(Vector3 rotation);
+
+Matrix4x3 matrix4x3_axis_angle(Vector3 axis, float angle);
+
+Matrix4x3 matrix4x3_transform(Vector3 position, Vector3 rotation, Vector3 scale);
+
+Matrix4x4 matrix4x3_to_matrix4x4(const Matrix4x3* matrix);
+
+void matrix4x3_multiply(const Matrix4x3* a, const Matrix4x3* b, Matrix4x3* result);
+
+int matrix4x3_normal_matrix(const Matrix4x3* matrix, Matrix4x3* result);
+
+int matrix4x3_inverse(const Matrix4x3* matrix, Matrix4x3* result);
+
+void vector3_multiply_matrix4x3(const Vector3* in, Vector3* out, const Matrix4x3* matrix);
+
+void vector3_rotate_matrix4x3(const Vector3* in, Vector3* out, const Matrix4x3* matrix);
+
+#endif //INC_3D_MATRIX4X3_H
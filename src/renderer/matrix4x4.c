@@ -89,6 +89,23 @@ void vector3_multiply_matrix4x4(const Vector3* in, Vector3* out, const Matrix4x4
     }
 }
 
+/**
+ * @brief Applies a projection matrix built by matrix4X4_projection to a view-space point.
+ *
+ * Only the five non-zero terms of the projection are evaluated, the full result is kept for clipping.
+ *
+ * @param in The view-space point.
+ * @param out The clip-space point.
+ * @param projection The projection matrix.
+ */
+
+void vector3_multiply_projection(const Vector3* in, Vector4* out, const Matrix4x4* projection) {
+    out->x = in->x * projection->m[0][0];
+    out->y = in->y * projection->m[1][1];
+    out->z = in->z * projection->m[2][2] + projection->m[3][2];
+    out->w = in->z * projection->m[2][3];
+}
+
 /**
  * @brief Multiplies two 4x4 matrices and stores the result in another 4x4 matrix.
  *
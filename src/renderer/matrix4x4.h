@@ -6,6 +6,7 @@
 #define INC_3D_MATRIX4X4_H
 
 #include "vector3.h"
+#include "vector4.h"
 
 #define PI 3.14159265f
 
@@ -19,6 +20,8 @@ Matrix4x4 matrix4X4_projection(int fovDegree, float aspectRatio, float near, flo
 
 void vector3_multiply_matrix4x4(const Vector3* in, Vector3* out, const Matrix4x4* matrix);
 
+void vector3_multiply_projection(const Vector3* in, Vector4* out, const Matrix4x4* projection);
+
 void matrix4x4_multiply(const Matrix4x4* a, const Matrix4x4* b, Matrix4x4* result);
 
 void matrix4x4_rotate_y(Matrix4x4* matrix, float angle, Matrix4x4* result);
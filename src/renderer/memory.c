@@ -0,0 +1,111 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "memory.h"
+
+// Stored in front of every block, keeps the block aligned like malloc would
+typedef union {
+    size_t size;
+    max_align_t align;
+} MemoryHeader;
+
+static void* memory_libc_realloc(void* pointer, size_t size);
+
+// The C library until memory_init, it ends up in the same allocator on the device
+static void* (*memoryHook)(void* pointer, size_t size) = memory_libc_realloc;
+
+static MemoryStats stats;
+
+/**
+ * @brief Routes all further allocations through the realloc hook of the PlaydateAPI.
+ */
+
+void memory_init(PlaydateAPI* api) {
+    memoryHook = api->system->realloc;
+}
+
+void* memory_alloc(size_t size) {
+    return memory_realloc(NULL, size);
+}
+
+void* memory_calloc(size_t count, size_t size) {
+    // Like calloc, a product that doesn't fit into size_t fails instead of wrapping around
+    if (size != 0 && count > SIZE_MAX / size)
+        return NULL;
+
+    void* pointer = memory_alloc(count * size);
+    if (pointer != NULL)
+        memset(pointer, 0, count * size);
+    return pointer;
+}
+
+/**
+ * @brief Resizes a block like realloc and keeps the stats up to date. Every block carries its size in a
+ * header, the hook itself doesn't report sizes.
+ *
+ * @param pointer The block to resize, NULL to allocate a new one.
+ * @param size The new size, 0 frees the block.
+ * @return The resized block, NULL if it was freed or the allocation failed.
+ */
+
+void* memory_realloc(void* pointer, size_t size) {
+    MemoryHeader* header = pointer != NULL ? (MemoryHeader*) pointer - 1 : NULL;
+    size_t oldSize = header != NULL ? header->size : 0;
+
+    if (size == 0) {
+        if (header != NULL) {
+            memoryHook(header, 0);
+            stats.liveBytes -= oldSize;
+            stats.liveAllocations--;
+        }
+        return NULL;
+    }
+
+    // No room left for the header, the old block stays valid like with a failed realloc
+    if (size > SIZE_MAX - sizeof(MemoryHeader))
+        return NULL;
+
+    MemoryHeader* resized = memoryHook(header, sizeof(MemoryHeader) + size);
+    if (resized == NULL)
+        return NULL;
+
+    resized->size = size;
+    stats.liveBytes += size - oldSize;
+    stats.totalAllocations++;
+    stats.frameAllocations++;
+    if (header == NULL)
+        stats.liveAllocations++;
+    if (stats.liveBytes > stats.peakBytes)
+        stats.peakBytes = stats.liveBytes;
+
+    return resized + 1;
+}
+
+void memory_free(void* pointer) {
+    memory_realloc(pointer, 0);
+}
+
+/**
+ * @brief Starts counting the allocations of a new frame.
+ */
+
+void memory_begin_frame(void) {
+    stats.frameAllocations = 0;
+}
+
+const MemoryStats* memory_stats(void) {
+    return &stats;
+}
+
+static void* memory_libc_realloc(void* pointer, size_t size) {
+    if (size == 0) {
+        free(pointer);
+        return NULL;
+    }
+
+    return realloc(pointer, size);
+}
@@ -0,0 +1,36 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#ifndef INC_3D_MEMORY_H
+#define INC_3D_MEMORY_H
+
+#include <stddef.h>
+#include "pd_api.h"
+
+/**
+ * Heap usage of everything allocated through memory_alloc and friends.
+ */
+typedef struct {
+    size_t liveBytes;
+    size_t peakBytes;           // Highest liveBytes so far
+    int liveAllocations;
+    int totalAllocations;       // Allocations and reallocations so far
+    int frameAllocations;       // Allocations and reallocations since memory_begin_frame
+} MemoryStats;
+
+void memory_init(PlaydateAPI* api);
+
+void* memory_alloc(size_t size);
+
+void* memory_calloc(size_t count, size_t size);
+
+void* memory_realloc(void* pointer, size_t size);
+
+void memory_free(void* pointer);
+
+void memory_begin_frame(void);
+
+const MemoryStats* memory_stats(void);
+
+#endif //INC_3D_MEMORY_H
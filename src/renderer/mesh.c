@@ -0,0 +1,49 @@
+//
+// Created by Michael Berger on 7/14/23.
+//
+
+#include <stdlib.h>
+#include "mesh.h"
+#include "memory.h"
+
+/**
+ * @brief Frees the arrays of a mesh built at runtime. Baked meshes must not be destroyed.
+ */
+
+void destroy_mesh(Mesh* mesh) {
+    memory_free((void*) mesh->vertices);
+    memory_free((void*) mesh->indices);
+    memory_free((void*) mesh->normals);
+    memory_free((void*) mesh->planeDistances);
+}
+
+/**
+ * @brief Calculates the plane of every triangle once, so drawing only has to test and rotate them.
+ *
+ * @param mesh A mesh built at runtime, its normals and plane distances are allocated if missing.
+ */
+
+void mesh_compute_planes(Mesh* mesh) {
+    Vector3* normals = (Vector3*) mesh->normals;
+    float* planeDistances = (float*) mesh->planeDistances;
+
+    if (normals == NULL)
+        mesh->normals = normals = memory_alloc(sizeof(Vector3) * mesh->triangleCount);
+    if (planeDistances == NULL)
+        mesh->planeDistances = planeDistances = memory_alloc(sizeof(float) * mesh->triangleCount);
+
+    for (int i = 0; i < mesh->triangleCount; i++) {
+        const uint16_t* indices = &mesh->indices[i * 3];
+
+        Triangle triangle = {
+                .points = {
+                        mesh->vertices[indices[0]],
+                        mesh->vertices[indices[1]],
+                        mesh->vertices[indices[2]]
+                }
+        };
+
+        normals[i] = triangle_normal(&triangle);
+        planeDistances[i] = -vector3_dot_product(normals[i], triangle.points[0]);
+    }
+}
@@ -5,128 +5,41 @@
 #ifndef INC_3D_MESH_H
 #define INC_3D_MESH_H
 
+#include <stdint.h>
 #include "triangle.h"
+#include "bounds.h"
+
+// Most levels of detail of a mesh, the mesh itself included
+#define MESH_LOD_LEVELS 4
+
+/**
+ * Indexed triangle mesh. Every unique vertex is stored once and triangles refer to them
+ * through three consecutive entries of the index array.
+ *
+ * The arrays are read-only, so meshes baked at build time (see tools/bake_mesh.py) can live in ROM.
+ *
+ * A mesh can be the first of a chain of simplified levels of detail sharing its bounds. The renderer draws the
+ * coarser level once the projected radius of the bounds drops below lodRadius, the radius at which the error of
+ * the simplification stays under a pixel.
+ */
+typedef struct Mesh {
+    int vertexCount;
+    const Vector3* vertices;
 
-typedef struct {
     int triangleCount;
-    Triangle* triangles;
-} Mesh;
-
-void destroy_mesh(Mesh* mesh) {
-    free(mesh->triangles);
-}
-
-Mesh create_cube_mesh() {
-    Mesh cube = {
-            .triangleCount = 12,
-            .triangles = malloc(sizeof(Triangle) * 12)
-    };
-
-    // South
-    cube.triangles[0] = (Triangle) {
-            .points = {
-                    {.x = 0, .y = 0, .z = 0},
-                    {.x = 0, .y = 1, .z = 0},
-                    {.x = 1, .y = 1, .z = 0},
-            }
-    };
-    cube.triangles[1] = (Triangle) {
-            .points = {
-                    {.x = 0, .y = 0, .z = 0},
-                    {.x = 1, .y = 1, .z = 0},
-                    {.x = 1, .y = 0, .z = 0},
-            }
-    };
-    // East
-    cube.triangles[2] = (Triangle) {
-            .points = {
-                    {.x = 1, .y = 0, .z = 0},
-                    {.x = 1, .y = 1, .z = 0},
-                    {.x = 1, .y = 1, .z = 1},
-            }
-    };
-    cube.triangles[3] = (Triangle) {
-            .points = {
-                    {.x = 1, .y = 0, .z = 0},
-                    {.x = 1, .y = 1, .z = 1},
-                    {.x = 1, .y = 0, .z = 1},
-            }
-    };
+    const uint16_t* indices;
+    const Vector3* normals;     // Unit face normal of every triangle
+    const float* planeDistances;    // Plane offset of every triangle, dot(normal, p) + distance = 0 on the face
 
-    // North
-    cube.triangles[4] = (Triangle) {
-            .points = {
-                    {.x = 1, .y = 0, .z = 1},
-                    {.x = 1, .y = 1, .z = 1},
-                    {.x = 0, .y = 1, .z = 1},
-            }
-    };
-    cube.triangles[5] = (Triangle) {
-            .points = {
-                    {.x = 1, .y = 0, .z = 1},
-                    {.x = 0, .y = 1, .z = 1},
-                    {.x = 0, .y = 0, .z = 1},
-            }
-    };
+    // Object space sphere enclosing all vertices
+    BoundingSphere bounds;
 
-    // West
-    cube.triangles[6] = (Triangle) {
-            .points = {
-                    {.x = 0, .y = 0, .z = 1},
-                    {.x = 0, .y = 1, .z = 1},
-                    {.x = 0, .y = 1, .z = 0},
-            }
-    };
-    cube.triangles[7] = (Triangle) {
-            .points = {
-                    {.x = 0, .y = 0, .z = 1},
-                    {.x = 0, .y = 1, .z = 0},
-                    {.x = 0, .y = 0, .z = 0},
-            }
-    };
-
-    // Top
-    cube.triangles[8] = (Triangle) {
-            .points = {
-                    {.x = 0, .y = 1, .z = 0},
-                    {.x = 0, .y = 1, .z = 1},
-                    {.x = 1, .y = 1, .z = 1},
-            }
-    };
-    cube.triangles[9] = (Triangle) {
-            .points = {
-                    {.x = 0, .y = 1, .z = 0},
-                    {.x = 1, .y = 1, .z = 1},
-                    {.x = 1, .y = 1, .z = 0},
-            }
-    };
-
-    // Bottom
-    cube.triangles[10] = (Triangle) {
-            .points = {
-                    {.x = 1, .y = 0, .z = 1},
-                    {.x = 0, .y = 0, .z = 1},
-                    {.x = 0, .y = 0, .z = 0},
-            }
-    };
-    cube.triangles[11] = (Triangle) {
-            .points = {
-                    {.x = 1, .y = 0, .z = 1},
-                    {.x = 0, .y = 0, .z = 0},
-                    {.x = 1, .y = 0, .z = 0},
-            }
-    };
+    const struct Mesh* lod;     // Next coarser level of detail, NULL for the coarsest
+    float lodRadius;            // Projected radius in pixels below which lod is drawn instead
+} Mesh;
 
-    // Move origin to center
-    for (int i = 0; i < cube.triangleCount; i++) {
-        for (int p = 0; p < 3; p++) {
-            cube.triangles[i].points[p].x -= 0.5f;
-            cube.triangles[i].points[p].y -= 0.5f;
-            cube.triangles[i].points[p].z -= 0.5f;
-        }
-    }
+void destroy_mesh(Mesh* mesh);
 
-    return cube;
-}
+void mesh_compute_planes(Mesh* mesh);
 
 #endif //INC_3D_MESH_H
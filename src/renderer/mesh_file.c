@@ -0,0 +1,257 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#include <string.h>
+#include "mesh_file.h"
+#include "memory.h"
+
+#ifdef TARGET_HOST
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static int mesh_file_read(MeshFile* file, PlaydateAPI* api, const char* path);
+
+static int mesh_file_block_fits(const MeshFile* file, uint32_t offset, uint64_t bytes);
+
+static const char* mesh_file_validate_level(const MeshFile* file, const MeshFileLod* level);
+
+static const char* mesh_file_validate(const MeshFile* file);
+
+static int mesh_file_bind(MeshFile* file, PlaydateAPI* api, const char* name);
+
+/**
+ * @brief Loads a binary mesh file and points the mesh at its blocks.
+ *
+ * The file is brought into memory as a whole, memory mapped on the host and with a single read through the
+ * file API on the device. After checking the header and the indices nothing is converted.
+ *
+ * @param file Receives the mesh and the file data.
+ * @param api The PlaydateAPI used to read the file.
+ * @param path The file, in the data folder or the game bundle.
+ * @return 1 on success, 0 if the file couldn't be read or is not a valid mesh file. The reason is logged.
+ */
+
+int mesh_file_load(MeshFile* file, PlaydateAPI* api, const char* path) {
+    memset(file, 0, sizeof(MeshFile));
+
+    if (!mesh_file_read(file, api, path))
+        return 0;
+
+    return mesh_file_bind(file, api, path);
+}
+
+/**
+ * @brief Points the mesh at the blocks of a mesh file that is already in memory, e.g. read piece by piece.
+ *
+ * @param file Receives the mesh.
+ * @param api The PlaydateAPI used to log errors.
+ * @param data The whole file, allocated with memory_alloc. The mesh file takes ownership, it is freed on failure.
+ * @param size Size of the file in bytes.
+ * @param name Name of the file for error messages.
+ * @return 1 on success, 0 if the data is not a valid mesh file. The reason is logged.
+ */
+
+int mesh_file_load_buffer(MeshFile* file, PlaydateAPI* api, void* data, size_t size, const char* name) {
+    memset(file, 0, sizeof(MeshFile));
+    file->data = data;
+    file->size = size;
+
+    return mesh_file_bind(file, api, name);
+}
+
+void mesh_file_unload(MeshFile* file) {
+#ifdef TARGET_HOST
+    if (file->mapped) {
+        munmap(file->data, file->size);
+        file->data = NULL;
+    }
+#endif
+
+    memory_free(file->data);
+    file->data = NULL;
+    file->size = 0;
+    file->mapped = 0;
+}
+
+static int mesh_file_bind(MeshFile* file, PlaydateAPI* api, const char* name) {
+    const char* error = mesh_file_validate(file);
+    if (error != NULL) {
+        api->system->logToConsole("Couldn't load mesh %s: %s", name, error);
+        mesh_file_unload(file);
+        return 0;
+    }
+
+    const uint8_t* data = file->data;
+    const MeshFileHeader* header = file->data;
+    const MeshFileLod* lods = (const MeshFileLod*) (data + header->lodOffset);
+
+    file->mesh = (Mesh) {
+            .vertexCount = (int) header->vertexCount,
+            .vertices = (const Vector3*) (data + header->vertexOffset),
+            .triangleCount = (int) header->triangleCount,
+            .indices = (const uint16_t*) (data + header->indexOffset),
+            .normals = (const Vector3*) (data + header->normalOffset),
+            .planeDistances = (const float*) (data + header->planeOffset),
+            .bounds = header->bounds
+    };
+
+    Mesh* previous = &file->mesh;
+    for (uint32_t i = 0; i < header->lodCount; i++) {
+        const MeshFileLod* lod = &lods[i];
+
+        file->levels[i] = (Mesh) {
+                .vertexCount = (int) lod->vertexCount,
+                .vertices = (const Vector3*) (data + lod->vertexOffset),
+                .triangleCount = (int) lod->triangleCount,
+                .indices = (const uint16_t*) (data + lod->indexOffset),
+                .normals = (const Vector3*) (data + lod->normalOffset),
+                .planeDistances = (const float*) (data + lod->planeOffset),
+                .bounds = header->bounds
+        };
+
+        previous->lod = &file->levels[i];
+        previous->lodRadius = lod->radius;
+        previous = &file->levels[i];
+    }
+
+    return 1;
+}
+
+#ifdef TARGET_HOST
+
+static int mesh_file_read(MeshFile* file, PlaydateAPI* api, const char* path) {
+    int descriptor = open(path, O_RDONLY);
+    struct stat info;
+
+    if (descriptor < 0 || fstat(descriptor, &info) != 0 || info.st_size == 0) {
+        api->system->logToConsole("Couldn't open mesh %s", path);
+        if (descriptor >= 0)
+            close(descriptor);
+        return 0;
+    }
+
+    void* data = mmap(NULL, (size_t) info.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+
+    if (data == MAP_FAILED) {
+        api->system->logToConsole("Couldn't map mesh %s", path);
+        return 0;
+    }
+
+    file->data = data;
+    file->size = (size_t) info.st_size;
+    file->mapped = 1;
+    return 1;
+}
+
+#else
+
+static int mesh_file_read(MeshFile* file, PlaydateAPI* api, const char* path) {
+    const struct playdate_file* files = api->file;
+
+    FileStat info;
+    if (files->stat(path, &info) != 0 || info.size == 0) {
+        api->system->logToConsole("Couldn't open mesh %s: %s", path, files->geterr());
+        return 0;
+    }
+
+    SDFile* handle = files->open(path, kFileRead | kFileReadData);
+    if (handle == NULL) {
+        api->system->logToConsole("Couldn't open mesh %s: %s", path, files->geterr());
+        return 0;
+    }
+
+    file->data = memory_alloc(info.size);
+    if (file->data == NULL) {
+        api->system->logToConsole("Couldn't allocate %u bytes for mesh %s", info.size, path);
+        files->close(handle);
+        return 0;
+    }
+
+    file->size = info.size;
+
+    int read = files->read(handle, file->data, info.size);
+    files->close(handle);
+
+    if (read != (int) info.size) {
+        api->system->logToConsole("Couldn't read mesh %s: %s", path, files->geterr());
+        mesh_file_unload(file);
+        return 0;
+    }
+
+    return 1;
+}
+
+#endif
+
+static int mesh_file_block_fits(const MeshFile* file, uint32_t offset, uint64_t bytes) {
+    return offset % 4 == 0 && (uint64_t) offset + bytes <= file->size;
+}
+
+/**
+ * @brief Checks that the header describes blocks inside the file and every index names a vertex, so drawing
+ * the mesh never reads outside of the file.
+ *
+ * @return NULL if the file is valid, otherwise the reason it isn't.
+ */
+
+static const char* mesh_file_validate(const MeshFile* file) {
+    const MeshFileHeader* header = file->data;
+
+    if (file->size < sizeof(MeshFileHeader) || memcmp(header->magic, MESH_FILE_MAGIC, 4) != 0)
+        return "not a mesh file";
+    if (header->version != MESH_FILE_VERSION || header->headerSize != sizeof(MeshFileHeader))
+        return "unsupported version";
+    if (header->fileSize != file->size)
+        return "truncated";
+    if (header->lodCount > MESH_LOD_LEVELS - 1 ||
+        !mesh_file_block_fits(file, header->lodOffset, header->lodCount * sizeof(MeshFileLod)))
+        return "invalid level of detail table";
+
+    MeshFileLod level = {
+            .vertexCount = header->vertexCount,
+            .triangleCount = header->triangleCount,
+            .vertexOffset = header->vertexOffset,
+            .indexOffset = header->indexOffset,
+            .normalOffset = header->normalOffset,
+            .planeOffset = header->planeOffset
+    };
+
+    const char* error = mesh_file_validate_level(file, &level);
+
+    const MeshFileLod* lods = (const MeshFileLod*) ((const uint8_t*) file->data + header->lodOffset);
+    for (uint32_t i = 0; error == NULL && i < header->lodCount; i++)
+        error = mesh_file_validate_level(file, &lods[i]);
+
+    return error;
+}
+
+/**
+ * @brief Checks the blocks and indices of a single level of detail.
+ *
+ * @return NULL if the level is valid, otherwise the reason it isn't.
+ */
+
+static const char* mesh_file_validate_level(const MeshFile* file, const MeshFileLod* level) {
+    if (level->vertexCount > UINT16_MAX + 1u || level->triangleCount > INT32_MAX / 3)
+        return "too many vertices or triangles";
+
+    uint64_t triangles = level->triangleCount;
+    if (!mesh_file_block_fits(file, level->vertexOffset, level->vertexCount * sizeof(Vector3)) ||
+        !mesh_file_block_fits(file, level->indexOffset, triangles * 3 * sizeof(uint16_t)) ||
+        !mesh_file_block_fits(file, level->normalOffset, triangles * sizeof(Vector3)) ||
+        !mesh_file_block_fits(file, level->planeOffset, triangles * sizeof(float)))
+        return "block outside of the file";
+
+    const uint16_t* indices = (const uint16_t*) ((const uint8_t*) file->data + level->indexOffset);
+    for (uint64_t i = 0; i < triangles * 3; i++) {
+        if (indices[i] >= level->vertexCount)
+            return "index out of range";
+    }
+
+    return NULL;
+}
@@ -0,0 +1,73 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#ifndef INC_3D_MESH_FILE_H
+#define INC_3D_MESH_FILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "pd_api.h"
+#include "mesh.h"
+
+#define MESH_FILE_MAGIC "P3DM"
+#define MESH_FILE_VERSION 2
+
+/**
+ * Header at the start of a binary mesh file, written by tools/bake_mesh.py --binary. The blocks it points at
+ * hold the arrays of a Mesh exactly as they are laid out in memory, little endian and starting at multiples of
+ * 4 bytes, so a loaded file is used in place without parsing. The coarser levels of detail follow in the same
+ * layout, described by a table of MeshFileLod.
+ */
+typedef struct {
+    char magic[4];          // MESH_FILE_MAGIC
+    uint16_t version;       // MESH_FILE_VERSION
+    uint16_t headerSize;    // sizeof(MeshFileHeader)
+    uint32_t vertexCount;
+    uint32_t triangleCount;
+    BoundingSphere bounds;
+    uint32_t vertexOffset;  // vertexCount Vector3
+    uint32_t indexOffset;   // triangleCount * 3 uint16_t
+    uint32_t normalOffset;  // triangleCount Vector3
+    uint32_t planeOffset;   // triangleCount float
+    uint32_t lodCount;      // Coarser levels of detail, at most MESH_LOD_LEVELS - 1
+    uint32_t lodOffset;     // lodCount MeshFileLod, finest first
+    uint32_t fileSize;
+} MeshFileHeader;
+
+_Static_assert(sizeof(MeshFileHeader) == 60, "MeshFileHeader must match the file layout");
+
+/**
+ * A coarser level of detail of a binary mesh file, it shares the bounds of the header.
+ */
+typedef struct {
+    float radius;           // Projected radius in pixels below which the level replaces the previous one
+    uint32_t vertexCount;
+    uint32_t triangleCount;
+    uint32_t vertexOffset;
+    uint32_t indexOffset;
+    uint32_t normalOffset;
+    uint32_t planeOffset;
+} MeshFileLod;
+
+_Static_assert(sizeof(MeshFileLod) == 28, "MeshFileLod must match the file layout");
+
+/**
+ * A mesh whose arrays point into the loaded file. The levels of detail are chained from mesh to levels, so a
+ * loaded MeshFile must not be moved.
+ */
+typedef struct {
+    Mesh mesh;
+    Mesh levels[MESH_LOD_LEVELS - 1];
+    void* data;     // The whole file, NULL when nothing is loaded
+    size_t size;
+    int mapped;     // The file is memory mapped instead of read, host build only
+} MeshFile;
+
+int mesh_file_load(MeshFile* file, PlaydateAPI* api, const char* path);
+
+int mesh_file_load_buffer(MeshFile* file, PlaydateAPI* api, void* data, size_t size, const char* name);
+
+void mesh_file_unload(MeshFile* file);
+
+#endif //INC_3D_MESH_FILE_H
@@ -0,0 +1,85 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#include "pool.h"
+#include "arena.h"
+#include "memory.h"
+
+/**
+ * @brief Initializes an empty pool, the first slab is allocated with the first item.
+ *
+ * @param pool The pool to initialize.
+ * @param itemSize Size of one item.
+ * @param itemsPerSlab Items allocated at once whenever the pool runs out.
+ */
+
+void pool_init(Pool* pool, size_t itemSize, int itemsPerSlab) {
+    size_t size = itemSize > sizeof(PoolItem) ? itemSize : sizeof(PoolItem);
+
+    pool->itemSize = ARENA_SIZE(size);
+    pool->itemsPerSlab = itemsPerSlab;
+    pool->slabs = NULL;
+    pool->free = NULL;
+    pool->liveCount = 0;
+    pool->capacity = 0;
+}
+
+/**
+ * @brief Frees every slab, items still in use are freed with them.
+ */
+
+void pool_destroy(Pool* pool) {
+    while (pool->slabs != NULL) {
+        PoolSlab* next = pool->slabs->next;
+        memory_free(pool->slabs);
+        pool->slabs = next;
+    }
+
+    pool->free = NULL;
+    pool->liveCount = 0;
+    pool->capacity = 0;
+}
+
+/**
+ * @brief Takes an item off the free list, a new slab is allocated when the list is empty.
+ *
+ * @return The item, NULL if a new slab was needed and couldn't be allocated.
+ */
+
+void* pool_alloc(Pool* pool) {
+    if (pool->free == NULL) {
+        size_t header = ARENA_SIZE(sizeof(PoolSlab));
+        PoolSlab* slab = memory_alloc(header + pool->itemSize * pool->itemsPerSlab);
+        if (slab == NULL)
+            return NULL;
+
+        slab->next = pool->slabs;
+        pool->slabs = slab;
+        pool->capacity += pool->itemsPerSlab;
+
+        // Thread the items of the new slab onto the free list, first item first
+        unsigned char* items = (unsigned char*) slab + header;
+        for (int i = pool->itemsPerSlab - 1; i >= 0; i--) {
+            PoolItem* item = (PoolItem*) (items + pool->itemSize * i);
+            item->next = pool->free;
+            pool->free = item;
+        }
+    }
+
+    PoolItem* item = pool->free;
+    pool->free = item->next;
+    pool->liveCount++;
+
+    return item;
+}
+
+void pool_free(Pool* pool, void* item) {
+    if (item == NULL)
+        return;
+
+    PoolItem* freed = item;
+    freed->next = pool->free;
+    pool->free = freed;
+    pool->liveCount--;
+}
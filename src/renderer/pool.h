@@ -0,0 +1,39 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#ifndef INC_3D_POOL_H
+#define INC_3D_POOL_H
+
+#include <stddef.h>
+
+typedef struct PoolItem {
+    struct PoolItem* next;
+} PoolItem;
+
+typedef struct PoolSlab {
+    struct PoolSlab* next;
+} PoolSlab;
+
+/**
+ * Fixed-size items carved out of slabs of several items. Freed items go onto a free list and are handed out
+ * again, so objects that come and go don't reach the heap once the pool is large enough.
+ */
+typedef struct {
+    size_t itemSize;
+    int itemsPerSlab;
+    PoolSlab* slabs;
+    PoolItem* free;
+    int liveCount;
+    int capacity;       // Items of all slabs
+} Pool;
+
+void pool_init(Pool* pool, size_t itemSize, int itemsPerSlab);
+
+void pool_destroy(Pool* pool);
+
+void* pool_alloc(Pool* pool);
+
+void pool_free(Pool* pool, void* item);
+
+#endif //INC_3D_POOL_H
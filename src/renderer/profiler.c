@@ -0,0 +1,159 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#include <stdio.h>
+#include "profiler.h"
+
+static const char* const stageNames[PROFILE_STAGE_COUNT] = {"xform", "cull", "sort", "fill", "line"};
+
+/**
+ * @brief Initializes a profiler without a CSV file.
+ *
+ * @param profiler The profiler to initialize.
+ * @param api The PlaydateAPI used for timing, drawing and files.
+ */
+
+void profiler_init(Profiler* profiler, PlaydateAPI* api) {
+    memset(profiler, 0, sizeof(Profiler));
+    profiler->api = api;
+}
+
+void profiler_destroy(Profiler* profiler) {
+    if (profiler->csv != NULL)
+        profiler->api->file->close(profiler->csv);
+
+    profiler->csv = NULL;
+}
+
+/**
+ * @brief Appends a row per frame to a CSV file in the data folder of the game.
+ *
+ * The header is only written if the file doesn't exist yet, so consecutive runs share one file.
+ *
+ * @param profiler The profiler.
+ * @param path The CSV file.
+ * @return 1 on success, 0 if the file couldn't be opened.
+ */
+
+int profiler_open_csv(Profiler* profiler, const char* path) {
+    const struct playdate_file* file = profiler->api->file;
+
+    FileStat stat;
+    int exists = file->stat(path, &stat) == 0;
+
+    profiler->csv = file->open(path, kFileAppend);
+    if (profiler->csv == NULL) {
+        profiler->api->system->logToConsole("Couldn't open %s: %s", path, file->geterr());
+        return 0;
+    }
+
+    if (!exists) {
+        static const char header[] = "frame,transform_ms,cull_ms,sort_ms,fill_ms,line_ms,submitted,culled,drawn,area\n";
+        file->write(profiler->csv, header, sizeof(header) - 1);
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Starts a frame. The stage timers read the elapsed time of the system, which the application resets
+ * at the start of every update.
+ */
+
+void profiler_begin_frame(Profiler* profiler) {
+    for (int i = 0; i < PROFILE_STAGE_COUNT; i++)
+        profiler->stageTime[i] = 0.0f;
+
+    for (int i = 0; i < PROFILE_COUNTER_COUNT; i++)
+        profiler->counters[i] = 0;
+}
+
+/**
+ * @brief Moves the stage times of the frame into the history and writes them to the CSV file.
+ */
+
+void profiler_end_frame(Profiler* profiler) {
+    for (int i = 0; i < PROFILE_STAGE_COUNT; i++)
+        profiler->history[i][profiler->historyIndex] = profiler->stageTime[i];
+
+    profiler->historyIndex = (profiler->historyIndex + 1) % PROFILER_HISTORY;
+    if (profiler->historyCount < PROFILER_HISTORY)
+        profiler->historyCount++;
+
+    if (profiler->csv != NULL) {
+        char line[160];
+        int length = snprintf(
+                line, sizeof(line), "%d,%.3f,%.3f,%.3f,%.3f,%.3f,%d,%d,%d,%d\n",
+                profiler->frame,
+                1000.0f * profiler->stageTime[PROFILE_STAGE_TRANSFORM],
+                1000.0f * profiler->stageTime[PROFILE_STAGE_CULL],
+                1000.0f * profiler->stageTime[PROFILE_STAGE_SORT],
+                1000.0f * profiler->stageTime[PROFILE_STAGE_FILL],
+                1000.0f * profiler->stageTime[PROFILE_STAGE_LINE],
+                profiler->counters[PROFILE_COUNTER_SUBMITTED],
+                profiler->counters[PROFILE_COUNTER_CULLED],
+                profiler->counters[PROFILE_COUNTER_DRAWN],
+                profiler->counters[PROFILE_COUNTER_AREA]
+        );
+
+        profiler->api->file->write(profiler->csv, line, (unsigned int) length);
+    }
+
+    profiler->frame++;
+}
+
+/**
+ * @brief Draws the average and maximum time of every stage over the history, each followed by a bar
+ * histogram of its last frames, and the triangle counts of the last frame.
+ *
+ * The overlay covers PROFILER_OVERLAY_WIDTH x PROFILER_OVERLAY_HEIGHT pixels.
+ *
+ * @param profiler The profiler.
+ * @param font The font of the text.
+ * @param x Left edge of the overlay.
+ * @param y Top edge of the overlay.
+ */
+
+void profiler_draw_overlay(const Profiler* profiler, LCDFont* font, int x, int y) {
+    const struct playdate_graphics* graphics = profiler->api->graphics;
+    char text[48];
+
+    graphics->fillRect(x, y, PROFILER_OVERLAY_WIDTH, PROFILER_OVERLAY_HEIGHT, kColorWhite);
+    graphics->setFont(font);
+
+    for (int stage = 0; stage < PROFILE_STAGE_COUNT; stage++) {
+        int top = y + stage * PROFILER_LINE_HEIGHT;
+
+        float total = 0.0f, peak = 0.0f;
+        for (int i = 0; i < profiler->historyCount; i++) {
+            total += profiler->history[stage][i];
+            peak = profiler->history[stage][i] > peak ? profiler->history[stage][i] : peak;
+        }
+
+        float average = profiler->historyCount > 0 ? total / (float) profiler->historyCount : 0.0f;
+        int length = snprintf(text, sizeof(text), "%s %.1f/%.1f", stageNames[stage], 1000.0f * average, 1000.0f * peak);
+        graphics->drawText(text, length, kASCIIEncoding, x, top);
+
+        if (peak <= 0.0f)
+            continue;
+
+        // Oldest frame on the left, bars scaled to the slowest frame
+        for (int i = 0; i < profiler->historyCount; i++) {
+            int index = (profiler->historyIndex - profiler->historyCount + i + PROFILER_HISTORY) % PROFILER_HISTORY;
+            int bar = (int) ((float) (PROFILER_LINE_HEIGHT - 2) * profiler->history[stage][index] / peak + 0.5f);
+
+            if (bar > 0)
+                graphics->fillRect(x + PROFILER_TEXT_WIDTH + i, top + PROFILER_LINE_HEIGHT - 1 - bar, 1, bar, kColorBlack);
+        }
+    }
+
+    int length = snprintf(
+            text, sizeof(text), "tri %d-%d=%d area %d",
+            profiler->counters[PROFILE_COUNTER_SUBMITTED],
+            profiler->counters[PROFILE_COUNTER_CULLED],
+            profiler->counters[PROFILE_COUNTER_DRAWN],
+            profiler->counters[PROFILE_COUNTER_AREA]
+    );
+    graphics->drawText(text, length, kASCIIEncoding, x, y + PROFILE_STAGE_COUNT * PROFILER_LINE_HEIGHT);
+}
@@ -0,0 +1,90 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#ifndef INC_3D_PROFILER_H
+#define INC_3D_PROFILER_H
+
+#include "pd_api.h"
+
+// Frames kept per stage for the rolling histogram
+#define PROFILER_HISTORY 32
+
+// Height of one overlay line, fits Roobert-10-Bold
+#define PROFILER_LINE_HEIGHT 12
+
+// Width of the text column of the overlay, the histogram bars follow it
+#define PROFILER_TEXT_WIDTH 76
+
+// Width of the overlay in pixels, text followed by one histogram bar per frame
+#define PROFILER_OVERLAY_WIDTH (PROFILER_TEXT_WIDTH + PROFILER_HISTORY)
+
+// One line per stage and one for the counters
+#define PROFILER_OVERLAY_HEIGHT ((PROFILE_STAGE_COUNT + 1) * PROFILER_LINE_HEIGHT)
+
+typedef enum {
+    PROFILE_STAGE_TRANSFORM,
+    PROFILE_STAGE_CULL,
+    PROFILE_STAGE_SORT,
+    PROFILE_STAGE_FILL,
+    PROFILE_STAGE_LINE,
+    PROFILE_STAGE_COUNT
+} ProfileStage;
+
+typedef enum {
+    PROFILE_COUNTER_SUBMITTED,  // Triangles of all gathered meshes
+    PROFILE_COUNTER_CULLED,     // Triangles facing away or outside of the view volume
+    PROFILE_COUNTER_DRAWN,      // Triangles handed to the fill engine
+    PROFILE_COUNTER_AREA,       // Analytic screen area of the drawn triangles, not the written pixels
+    PROFILE_COUNTER_COUNT
+} ProfileCounter;
+
+/**
+ * Time spent per render stage and triangle counts of the current frame, plus the stage times of the last
+ * PROFILER_HISTORY frames.
+ */
+typedef struct {
+    PlaydateAPI* api;
+    SDFile* csv;        // NULL unless a CSV file is written
+
+    int frame;
+    float stageTime[PROFILE_STAGE_COUNT];
+    int counters[PROFILE_COUNTER_COUNT];
+
+    int historyIndex;
+    int historyCount;
+    float history[PROFILE_STAGE_COUNT][PROFILER_HISTORY];
+} Profiler;
+
+void profiler_init(Profiler* profiler, PlaydateAPI* api);
+
+void profiler_destroy(Profiler* profiler);
+
+int profiler_open_csv(Profiler* profiler, const char* path);
+
+void profiler_begin_frame(Profiler* profiler);
+
+void profiler_end_frame(Profiler* profiler);
+
+void profiler_draw_overlay(const Profiler* profiler, LCDFont* font, int x, int y);
+
+static inline float profiler_now(const Profiler* profiler) {
+    return profiler->api->system->getElapsedTime();
+}
+
+#ifdef RENDERER_PROFILE
+
+// Times the code between PROFILE_BEGIN and PROFILE_END of the same stage in the same scope
+#define PROFILE_BEGIN(profiler, stage) float profileStart_##stage = profiler_now(profiler)
+#define PROFILE_END(profiler, stage) ((profiler)->stageTime[stage] += profiler_now(profiler) - profileStart_##stage)
+#define PROFILE_COUNT(profiler, counter, amount) ((profiler)->counters[counter] += (amount))
+
+#else
+
+#define PROFILE_BEGIN(profiler, stage) ((void) 0)
+#define PROFILE_END(profiler, stage) ((void) 0)
+#define PROFILE_COUNT(profiler, counter, amount) ((void) 0)
+
+#endif
+
+#endif //INC_3D_PROFILER_H
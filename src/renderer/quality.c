@@ -0,0 +1,109 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#include "quality.h"
+#include "bayer.h"
+
+// Weight of the newest frame time in the smoothed frame time
+#define QUALITY_SMOOTHING 0.25f
+
+// Share of the budget a frame may take to count as headroom
+#define QUALITY_HEADROOM 0.6f
+
+// Consecutive slow frames before stepping down
+#define QUALITY_DOWN_FRAMES 4
+
+// Consecutive fast frames before stepping up, doubled every time a step up had to be undone
+#define QUALITY_UP_FRAMES 45
+#define QUALITY_MAX_UP_FRAMES (QUALITY_UP_FRAMES * 16)
+
+// From the best to the cheapest, every level at most as expensive as the one before
+static const QualityLevel qualityLevels[] = {
+        {.scale = 2, .bayerSize = BAYER_8, .wireframe = 0, .lodBias = 1.0f},
+        {.scale = 2, .bayerSize = BAYER_8, .wireframe = 0, .lodBias = 0.5f},
+        {.scale = 2, .bayerSize = BAYER_4, .wireframe = 0, .lodBias = 0.5f},
+        {.scale = 4, .bayerSize = BAYER_4, .wireframe = 0, .lodBias = 0.5f},
+        {.scale = 4, .bayerSize = BAYER_2, .wireframe = 0, .lodBias = 0.5f},
+        {.scale = 4, .bayerSize = BAYER_2, .wireframe = 1, .lodBias = 0.5f},
+};
+
+#define QUALITY_LEVEL_COUNT ((int) (sizeof(qualityLevels) / sizeof(qualityLevels[0])))
+
+static void quality_governor_set_level(QualityGovernor* governor, int level);
+
+/**
+ * @brief Initializes a governor at the best quality level.
+ *
+ * @param governor The governor to initialize.
+ * @param refreshRate The refresh rate to hold, in frames per second.
+ */
+
+void quality_governor_init(QualityGovernor* governor, float refreshRate) {
+    governor->budget = 1.0f / refreshRate;
+    governor->upFrames = QUALITY_UP_FRAMES;
+    governor->steppedUp = 0;
+    quality_governor_set_level(governor, 0);
+}
+
+/**
+ * @brief Feeds the time of a drawn frame to the governor.
+ *
+ * Frames served without drawing, like cached frames, shouldn't be passed in, they say nothing about the cost
+ * of the quality level.
+ *
+ * @param governor The governor.
+ * @param frameTime Seconds spent on the frame.
+ * @return 1 if the quality level changed, 0 otherwise.
+ */
+
+int quality_governor_update(QualityGovernor* governor, float frameTime) {
+    if (governor->average == 0.0f)
+        governor->average = frameTime;
+    else
+        governor->average += (frameTime - governor->average) * QUALITY_SMOOTHING;
+
+    if (governor->average > governor->budget) {
+        governor->fastFrames = 0;
+
+        if (++governor->slowFrames < QUALITY_DOWN_FRAMES || governor->level == QUALITY_LEVEL_COUNT - 1)
+            return 0;
+
+        // The level above was too slow again, wait longer before trying it the next time
+        if (governor->steppedUp && governor->upFrames < QUALITY_MAX_UP_FRAMES)
+            governor->upFrames *= 2;
+
+        governor->steppedUp = 0;
+        quality_governor_set_level(governor, governor->level + 1);
+        return 1;
+    }
+
+    governor->slowFrames = 0;
+
+    if (governor->average > governor->budget * QUALITY_HEADROOM) {
+        governor->fastFrames = 0;
+        return 0;
+    }
+
+    if (++governor->fastFrames < governor->upFrames || governor->level == 0)
+        return 0;
+
+    governor->steppedUp = 1;
+    quality_governor_set_level(governor, governor->level - 1);
+    return 1;
+}
+
+/**
+ * @brief Returns the render settings of the current quality level.
+ */
+
+const QualityLevel* quality_governor_level(const QualityGovernor* governor) {
+    return &qualityLevels[governor->level];
+}
+
+static void quality_governor_set_level(QualityGovernor* governor, int level) {
+    governor->level = level;
+    governor->average = 0.0f;
+    governor->slowFrames = 0;
+    governor->fastFrames = 0;
+}
@@ -0,0 +1,39 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#ifndef INC_3D_QUALITY_H
+#define INC_3D_QUALITY_H
+
+/**
+ * Render settings of one quality level.
+ */
+typedef struct {
+    int scale;          // Display scale, 2 or 4
+    int bayerSize;      // Size of the dither threshold map
+    int wireframe;      // Only outlines are drawn
+    float lodBias;      // Scales the projected radius before choosing a level of detail, below 1 picks coarser levels
+} QualityLevel;
+
+/**
+ * Steps the render quality down while frames take longer than the refresh rate allows and back up when there
+ * is headroom. A level that was just left for being too slow has to prove itself for twice as long before it
+ * is tried again, so the quality doesn't oscillate between two levels.
+ */
+typedef struct {
+    float budget;       // Seconds per frame at the target refresh rate
+    float average;      // Smoothed frame time at the current level, 0 before the first frame
+    int level;          // Index into the quality levels, 0 is the best
+    int slowFrames;     // Consecutive frames over budget
+    int fastFrames;     // Consecutive frames with headroom
+    int upFrames;       // Fast frames needed before stepping up
+    int steppedUp;      // The last change was a step up
+} QualityGovernor;
+
+void quality_governor_init(QualityGovernor* governor, float refreshRate);
+
+int quality_governor_update(QualityGovernor* governor, float frameTime);
+
+const QualityLevel* quality_governor_level(const QualityGovernor* governor);
+
+#endif //INC_3D_QUALITY_H
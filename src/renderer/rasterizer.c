@@ -0,0 +1,377 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#include <math.h>
+#include "rasterizer.h"
+#include "pd_api.h"
+
+typedef struct {
+    int value;   // Edge function at the current block origin, biased by the fill rule
+    int stepX;   // Change of the edge function per pixel along x
+    int stepY;   // Change of the edge function per pixel along y
+    int minOffset;  // Offset from the block origin to the block corner with the smallest value
+    int maxOffset;  // Offset from the block origin to the block corner with the largest value
+} Edge;
+
+/**
+ * @brief Sets up the integer edge function for the edge a -> b.
+ *
+ * The edge function is positive on the inside of a counter-clockwise triangle. Pixels lying exactly
+ * on the edge are only kept for top and left edges, so triangles sharing an edge never cover the same pixel.
+ *
+ * @param edge The edge to initialize.
+ * @param ax X-coordinate of the edge start.
+ * @param ay Y-coordinate of the edge start.
+ * @param bx X-coordinate of the edge end.
+ * @param by Y-coordinate of the edge end.
+ * @param px X-coordinate of the point the edge function is evaluated at.
+ * @param py Y-coordinate of the point the edge function is evaluated at.
+ */
+
+static void edge_init(Edge* edge, int ax, int ay, int bx, int by, int px, int py) {
+    const int last = RASTERIZER_BLOCK_SIZE - 1;
+
+    edge->stepX = ay - by;
+    edge->stepY = bx - ax;
+
+    int topLeft = edge->stepX > 0 || (edge->stepX == 0 && edge->stepY > 0);
+    edge->value = edge->stepY * (py - ay) + edge->stepX * (px - ax) - (topLeft ? 0 : 1);
+
+    edge->minOffset = (edge->stepX < 0 ? edge->stepX * last : 0) + (edge->stepY < 0 ? edge->stepY * last : 0);
+    edge->maxOffset = (edge->stepX > 0 ? edge->stepX * last : 0) + (edge->stepY > 0 ? edge->stepY * last : 0);
+}
+
+/**
+ * @brief Writes a masked pattern byte into the frame buffer.
+ *
+ * Only the bits set in the mask are replaced by the pattern, all other bits keep their current value.
+ *
+ * @param frame Pointer to the frame byte.
+ * @param pattern The dither pattern byte.
+ * @param mask The coverage mask of the byte.
+ */
+
+static inline void write_masked(uint8_t* frame, uint8_t pattern, uint8_t mask) {
+    *frame = (*frame & ~mask) | (pattern & mask);
+}
+
+/**
+ * @brief Returns the pixels of a frame byte the screen door of a pattern lets through, all of them without a door.
+ */
+
+static inline uint8_t door_mask(const DitherPattern* pattern, int y, int byteIndex) {
+    if (pattern->door == NULL)
+        return 0xFF;
+
+    return dither_door_row(pattern, y)[byteIndex] ^ pattern->doorFlip;
+}
+
+/**
+ * @brief Fills a triangle into a 1-bit frame buffer using incremental half-space edge functions.
+ *
+ * The three edge functions are set up once per triangle and then stepped by integer additions only.
+ * The bounding box is walked in 8x8 pixel blocks aligned to the frame bytes. Every block is first tested
+ * against all three edges: blocks fully outside one edge are skipped, blocks fully inside all edges are
+ * written a whole byte per row, and only blocks straddling an edge are resolved per pixel.
+ *
+ * Triangles with any coordinate outside of RASTERIZER_GUARD_BAND are rejected, since their edge functions
+ * would overflow.
+ *
+ * @param frame Pointer to the frame buffer
+ * @param x1 X-coordinate of the first vertex of the triangle
+ * @param y1 Y-coordinate of the first vertex of the triangle
+ * @param x2 X-coordinate of the second vertex of the triangle
+ * @param y2 Y-coordinate of the second vertex of the triangle
+ * @param x3 X-coordinate of the third vertex of the triangle
+ * @param y3 Y-coordinate of the third vertex of the triangle
+ * @param frame_width Width of the frame buffer
+ * @param frame_height Height of the frame buffer
+ * @param pattern The dither pattern of the triangle brightness
+ */
+
+void rasterizer_fill_triangle(
+        uint8_t* frame,
+        int x1, int y1,
+        int x2, int y2,
+        int x3, int y3,
+        int frame_width, int frame_height,
+        const DitherPattern* pattern
+) {
+    const int size = RASTERIZER_BLOCK_SIZE;
+
+    if (x1 < -RASTERIZER_GUARD_BAND || x1 > RASTERIZER_GUARD_BAND || y1 < -RASTERIZER_GUARD_BAND || y1 > RASTERIZER_GUARD_BAND ||
+        x2 < -RASTERIZER_GUARD_BAND || x2 > RASTERIZER_GUARD_BAND || y2 < -RASTERIZER_GUARD_BAND || y2 > RASTERIZER_GUARD_BAND ||
+        x3 < -RASTERIZER_GUARD_BAND || x3 > RASTERIZER_GUARD_BAND || y3 < -RASTERIZER_GUARD_BAND || y3 > RASTERIZER_GUARD_BAND)
+        return;
+
+    // Bring the triangle into counter-clockwise order so the inside is positive for all edges
+    int area = (x2 - x1) * (y3 - y1) - (y2 - y1) * (x3 - x1);
+    if (area == 0)
+        return;
+
+    if (area < 0) {
+        int tx = x2, ty = y2;
+        x2 = x3, y2 = y3;
+        x3 = tx, y3 = ty;
+    }
+
+    // Calculate bounding box of the triangle, clipped to the frame
+    int xMin = x1 < x2 ? (x1 < x3 ? x1 : x3) : (x2 < x3 ? x2 : x3);
+    int xMax = x1 > x2 ? (x1 > x3 ? x1 : x3) : (x2 > x3 ? x2 : x3);
+    int yMin = y1 < y2 ? (y1 < y3 ? y1 : y3) : (y2 < y3 ? y2 : y3);
+    int yMax = y1 > y2 ? (y1 > y3 ? y1 : y3) : (y2 > y3 ? y2 : y3);
+
+    if (xMin < 0) xMin = 0;
+    if (yMin < 0) yMin = 0;
+    if (xMax > frame_width - 1) xMax = frame_width - 1;
+    if (yMax > frame_height - 1) yMax = frame_height - 1;
+
+    if (xMin > xMax || yMin > yMax)
+        return;
+
+    // Snap the start to the block grid so every block row is exactly one frame byte
+    xMin &= ~(size - 1);
+    yMin &= ~(size - 1);
+
+    Edge edges[3];
+    edge_init(&edges[0], x1, y1, x2, y2, xMin, yMin);
+    edge_init(&edges[1], x2, y2, x3, y3, xMin, yMin);
+    edge_init(&edges[2], x3, y3, x1, y1, xMin, yMin);
+
+    for (int blockY = yMin; blockY <= yMax; blockY += size) {
+        int rowEnd = blockY + size - 1 < frame_height - 1 ? blockY + size - 1 : frame_height - 1;
+
+        int e0 = edges[0].value;
+        int e1 = edges[1].value;
+        int e2 = edges[2].value;
+
+        for (int blockX = xMin; blockX <= xMax; blockX += size) {
+            // Reject the block if all four corners are outside a single edge
+            if (e0 + edges[0].maxOffset < 0 || e1 + edges[1].maxOffset < 0 || e2 + edges[2].maxOffset < 0) {
+                e0 += edges[0].stepX * size;
+                e1 += edges[1].stepX * size;
+                e2 += edges[2].stepX * size;
+                continue;
+            }
+
+            uint8_t columnMask = 0xFF;
+            if (blockX + size > frame_width)
+                columnMask = (uint8_t) (0xFF << (blockX + size - frame_width));
+
+            int byteIndex = blockX / 8;
+            uint8_t* byte = frame + blockY * LCD_ROWSIZE + byteIndex;
+            byteIndex &= pattern->byteMask;
+
+            if (((e0 + edges[0].minOffset) | (e1 + edges[1].minOffset) | (e2 + edges[2].minOffset)) >= 0) {
+                // Block is fully covered, write whole bytes
+                for (int y = blockY; y <= rowEnd; y++, byte += LCD_ROWSIZE)
+                    write_masked(byte, dither_pattern_row(pattern, y)[byteIndex], columnMask & door_mask(pattern, y, byteIndex));
+            } else {
+                // Block straddles an edge, resolve coverage per pixel
+                int r0 = e0, r1 = e1, r2 = e2;
+
+                for (int y = blockY; y <= rowEnd; y++, byte += LCD_ROWSIZE) {
+                    int p0 = r0, p1 = r1, p2 = r2;
+                    uint8_t mask = 0;
+
+                    for (int bit = 0x80; bit != 0; bit >>= 1) {
+                        if ((p0 | p1 | p2) >= 0)
+                            mask |= bit;
+
+                        p0 += edges[0].stepX;
+                        p1 += edges[1].stepX;
+                        p2 += edges[2].stepX;
+                    }
+
+                    mask &= columnMask & door_mask(pattern, y, byteIndex);
+                    if (mask != 0)
+                        write_masked(byte, dither_pattern_row(pattern, y)[byteIndex], mask);
+
+                    r0 += edges[0].stepY;
+                    r1 += edges[1].stepY;
+                    r2 += edges[2].stepY;
+                }
+            }
+
+            e0 += edges[0].stepX * size;
+            e1 += edges[1].stepX * size;
+            e2 += edges[2].stepX * size;
+        }
+
+        for (int i = 0; i < 3; i++)
+            edges[i].value += edges[i].stepY * size;
+    }
+}
+
+/**
+ * @brief Fills a triangle with a per-pixel depth test against a 16-bit depth buffer.
+ *
+ * Walks the same 8x8 blocks as rasterizer_fill_triangle, which line up with the depth buffer tiles.
+ * The whole triangle is rejected if its nearest vertex lies behind every tile it touches, and each block
+ * is rejected if the nearest depth of the triangle plane within it lies behind the farthest depth of its
+ * tile. Only the remaining blocks test and write single pixels, after which the tile depth is refreshed.
+ *
+ * Depth is interpolated linearly in screen space, which is exact for the normalized depth z/w.
+ *
+ * @param frame Pointer to the frame buffer
+ * @param x1 X-coordinate of the first vertex of the triangle
+ * @param y1 Y-coordinate of the first vertex of the triangle
+ * @param z1 Normalized depth of the first vertex of the triangle
+ * @param x2 X-coordinate of the second vertex of the triangle
+ * @param y2 Y-coordinate of the second vertex of the triangle
+ * @param z2 Normalized depth of the second vertex of the triangle
+ * @param x3 X-coordinate of the third vertex of the triangle
+ * @param y3 Y-coordinate of the third vertex of the triangle
+ * @param z3 Normalized depth of the third vertex of the triangle
+ * @param frame_width Width of the frame buffer
+ * @param frame_height Height of the frame buffer
+ * @param pattern The dither pattern of the triangle brightness
+ * @param depth The depth buffer, the same size as the frame
+ */
+
+void rasterizer_fill_triangle_depth(
+        uint8_t* frame,
+        int x1, int y1, float z1,
+        int x2, int y2, float z2,
+        int x3, int y3, float z3,
+        int frame_width, int frame_height,
+        const DitherPattern* pattern,
+        DepthBuffer* depth
+) {
+    const int size = RASTERIZER_BLOCK_SIZE;
+
+    if (x1 < -RASTERIZER_GUARD_BAND || x1 > RASTERIZER_GUARD_BAND || y1 < -RASTERIZER_GUARD_BAND || y1 > RASTERIZER_GUARD_BAND ||
+        x2 < -RASTERIZER_GUARD_BAND || x2 > RASTERIZER_GUARD_BAND || y2 < -RASTERIZER_GUARD_BAND || y2 > RASTERIZER_GUARD_BAND ||
+        x3 < -RASTERIZER_GUARD_BAND || x3 > RASTERIZER_GUARD_BAND || y3 < -RASTERIZER_GUARD_BAND || y3 > RASTERIZER_GUARD_BAND)
+        return;
+
+    int area = (x2 - x1) * (y3 - y1) - (y2 - y1) * (x3 - x1);
+    if (area == 0)
+        return;
+
+    if (area < 0) {
+        int tx = x2, ty = y2;
+        float tz = z2;
+        x2 = x3, y2 = y3, z2 = z3;
+        x3 = tx, y3 = ty, z3 = tz;
+        area = -area;
+    }
+
+    int xMin = x1 < x2 ? (x1 < x3 ? x1 : x3) : (x2 < x3 ? x2 : x3);
+    int xMax = x1 > x2 ? (x1 > x3 ? x1 : x3) : (x2 > x3 ? x2 : x3);
+    int yMin = y1 < y2 ? (y1 < y3 ? y1 : y3) : (y2 < y3 ? y2 : y3);
+    int yMax = y1 > y2 ? (y1 > y3 ? y1 : y3) : (y2 > y3 ? y2 : y3);
+
+    if (xMin < 0) xMin = 0;
+    if (yMin < 0) yMin = 0;
+    if (xMax > frame_width - 1) xMax = frame_width - 1;
+    if (yMax > frame_height - 1) yMax = frame_height - 1;
+
+    if (xMin > xMax || yMin > yMax)
+        return;
+
+    // Depth plane of the triangle in buffer units
+    float d1 = z1 * (float) DEPTH_BUFFER_FAR;
+    float d2 = z2 * (float) DEPTH_BUFFER_FAR;
+    float d3 = z3 * (float) DEPTH_BUFFER_FAR;
+    float stepX = ((d2 - d1) * (float) (y3 - y1) - (d3 - d1) * (float) (y2 - y1)) / (float) area;
+    float stepY = ((d3 - d1) * (float) (x2 - x1) - (d2 - d1) * (float) (x3 - x1)) / (float) area;
+
+    // Slivers snapped to whole pixels get a steep, inexact plane, so depths are kept within the vertex depths
+    float nearest = fminf(d1, fminf(d2, d3));
+    float farthest = fmaxf(d1, fmaxf(d2, d3));
+    if (nearest > (float) depth_buffer_max_in_rect(depth, xMin, yMin, xMax, yMax))
+        return;
+
+    // Offset from the block origin to the block corner nearest to the camera
+    float nearestOffset = fminf(stepX, 0.0f) * (float) (size - 1) + fminf(stepY, 0.0f) * (float) (size - 1);
+
+    xMin &= ~(size - 1);
+    yMin &= ~(size - 1);
+
+    Edge edges[3];
+    edge_init(&edges[0], x1, y1, x2, y2, xMin, yMin);
+    edge_init(&edges[1], x2, y2, x3, y3, xMin, yMin);
+    edge_init(&edges[2], x3, y3, x1, y1, xMin, yMin);
+
+    float rowDepth = d1 + stepX * (float) (xMin - x1) + stepY * (float) (yMin - y1);
+
+    for (int blockY = yMin; blockY <= yMax; blockY += size) {
+        int rowEnd = blockY + size - 1 < frame_height - 1 ? blockY + size - 1 : frame_height - 1;
+
+        int e0 = edges[0].value;
+        int e1 = edges[1].value;
+        int e2 = edges[2].value;
+        float blockDepth = rowDepth;
+
+        for (int blockX = xMin; blockX <= xMax; blockX += size) {
+            int tile = (blockY / size) * depth->tileColumns + blockX / size;
+
+            // Reject the block if it lies outside a single edge or behind everything drawn into its tile
+            if (e0 + edges[0].maxOffset < 0 || e1 + edges[1].maxOffset < 0 || e2 + edges[2].maxOffset < 0 ||
+                fmaxf(blockDepth + nearestOffset, nearest) > (float) depth->tileMax[tile]) {
+                e0 += edges[0].stepX * size;
+                e1 += edges[1].stepX * size;
+                e2 += edges[2].stepX * size;
+                blockDepth += stepX * (float) size;
+                continue;
+            }
+
+            int columnEnd = blockX + size < frame_width ? blockX + size : frame_width;
+            int byteIndex = blockX / 8;
+            uint8_t* byte = frame + blockY * LCD_ROWSIZE + byteIndex;
+            uint16_t* depthRow = depth->depth + blockY * depth->columns;
+            byteIndex &= pattern->byteMask;
+
+            int r0 = e0, r1 = e1, r2 = e2;
+            float r = blockDepth;
+            int written = 0;
+
+            for (int y = blockY; y <= rowEnd; y++, byte += LCD_ROWSIZE, depthRow += depth->columns) {
+                int p0 = r0, p1 = r1, p2 = r2;
+                float z = r;
+                uint8_t mask = 0;
+
+                for (int x = blockX, bit = 0x80; x < columnEnd; x++, bit >>= 1) {
+                    if ((p0 | p1 | p2) >= 0) {
+                        uint16_t pixelDepth = depth_buffer_quantize(fminf(fmaxf(z, nearest), farthest));
+
+                        if (pixelDepth < depthRow[x]) {
+                            depthRow[x] = pixelDepth;
+                            mask |= bit;
+                        }
+                    }
+
+                    p0 += edges[0].stepX;
+                    p1 += edges[1].stepX;
+                    p2 += edges[2].stepX;
+                    z += stepX;
+                }
+
+                if (mask != 0) {
+                    write_masked(byte, dither_pattern_row(pattern, y)[byteIndex], mask);
+                    written = 1;
+                }
+
+                r0 += edges[0].stepY;
+                r1 += edges[1].stepY;
+                r2 += edges[2].stepY;
+                r += stepY;
+            }
+
+            if (written)
+                depth_buffer_update_tile(depth, blockX / size, blockY / size);
+
+            e0 += edges[0].stepX * size;
+            e1 += edges[1].stepX * size;
+            e2 += edges[2].stepX * size;
+            blockDepth += stepX * (float) size;
+        }
+
+        for (int i = 0; i < 3; i++)
+            edges[i].value += edges[i].stepY * size;
+
+        rowDepth += stepY * (float) size;
+    }
+}
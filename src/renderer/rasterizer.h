@@ -0,0 +1,63 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#ifndef INC_3D_RASTERIZER_H
+#define INC_3D_RASTERIZER_H
+
+#include <stdint.h>
+#include "dither.h"
+#include "depth_buffer.h"
+
+// Size of the square pixel blocks tested against the triangle edges. One block row maps onto one frame byte.
+#define RASTERIZER_BLOCK_SIZE 8
+
+// The depth fill looks up the coarse depth of a block by its block index
+_Static_assert(RASTERIZER_BLOCK_SIZE == DEPTH_BUFFER_TILE_SIZE, "Rasterizer blocks must match the depth buffer tiles");
+
+// Largest vertex coordinate (in pixels) the integer edge functions can handle without overflowing.
+#define RASTERIZER_GUARD_BAND 8192
+
+/**
+ * Fills a triangle into a 1-bit frame buffer using incremental half-space edge functions.
+ *
+ * @param frame Pointer to the frame buffer (LCD_ROWSIZE bytes per row).
+ * @param x1 X-coordinate of the first vertex.
+ * @param y1 Y-coordinate of the first vertex.
+ * @param x2 X-coordinate of the second vertex.
+ * @param y2 Y-coordinate of the second vertex.
+ * @param x3 X-coordinate of the third vertex.
+ * @param y3 Y-coordinate of the third vertex.
+ * @param frame_width Width of the frame buffer in pixels.
+ * @param frame_height Height of the frame buffer in pixels.
+ * @param pattern The dither pattern of the triangle brightness.
+ */
+void rasterizer_fill_triangle(
+        uint8_t* frame,
+        int x1, int y1,
+        int x2, int y2,
+        int x3, int y3,
+        int frame_width, int frame_height,
+        const DitherPattern* pattern
+);
+
+/**
+ * Fills a triangle like rasterizer_fill_triangle, but only the pixels nearer than the depth buffer,
+ * and writes their depth.
+ *
+ * @param z1 Normalized depth of the first vertex, 0 at the near and 1 at the far plane.
+ * @param z2 Normalized depth of the second vertex.
+ * @param z3 Normalized depth of the third vertex.
+ * @param depth The depth buffer, the same size as the frame.
+ */
+void rasterizer_fill_triangle_depth(
+        uint8_t* frame,
+        int x1, int y1, float z1,
+        int x2, int y2, float z2,
+        int x3, int y3, float z3,
+        int frame_width, int frame_height,
+        const DitherPattern* pattern,
+        DepthBuffer* depth
+);
+
+#endif //INC_3D_RASTERIZER_H
@@ -2,48 +2,126 @@
 // Created by Michael Berger on 7/14/23.
 //
 
+#include <float.h>
+#include <string.h>
 #include "renderer.h"
 #include "bayer.h"
+#include "clip.h"
+#include "depth_sort.h"
+#include "dither.h"
+#include "dirty_region.h"
+#include "frustum.h"
 #include "mesh.h"
+#include "memory.h"
+#include "rasterizer.h"
+#include "scanline.h"
+#include "transform.h"
 
 LCDFont* font = NULL;
 
-const int BAYER_TABLE = BAYER_8;
-const float BAYER_MULTIPLIER = 64;
+// Depth a line may lie behind the depth buffer and still be drawn, so outlines stay on top of their own fill
+#define RENDERER_LINE_DEPTH_BIAS 256
 
-Mesh mesh;
+// Initial size of the frame arena, enough for a few small meshes
+#define RENDERER_FRAME_ARENA_SIZE (16 * 1024)
 
-void set_pixel_on(uint8_t* data, int byteIndex, int columnIndex);
+// Default width of the level of detail cross-fade band, see Renderer.lodFade
+#define RENDERER_LOD_FADE 0.25f
 
-void set_pixel_off(uint8_t* data, int byteIndex, int columnIndex);
+// Levels of detail of a node chosen for the frame
+typedef struct {
+    const Mesh* mesh;
+    const Mesh* fadeMesh;   // Coarser level drawn into the pixels mesh leaves out, NULL without a cross-fade
+    float fade;             // Share of the pixels drawn with mesh
+} LodSelection;
 
-int calculate_byte_index(int rowIndex, int columnIndex);
+// Geometry of the visible nodes of a frame, sizes the frame arena
+typedef struct {
+    const Renderer* renderer;
+    int vertexCount;
+    int triangleCount;
+    int largestMesh;        // Most triangles of a single mesh
+    int largestVertices;    // Most vertices of a single mesh
+} FrameGeometry;
+
+/**
+ * What keeps the triangles of a frame from drawing over each other, unused buffers are NULL.
+ */
+typedef struct {
+    SpanBuffer* coverage;   // Pixels already drawn, FILL_ENGINE_SPAN_BUFFER
+    DepthBuffer* depth;     // Nearest depth of every pixel, FILL_ENGINE_DEPTH_BUFFER
+} Occlusion;
 
-void renderer_draw_line(uint8_t* frame, int x1, int y1, int x2, int y2, int frame_width, int frame_height, int color);
+void set_pixel_on(uint8_t* data, int byteIndex, int columnIndex);
 
-void renderer_draw_line_by_vectors(uint8_t* data, Vector3 v1, Vector3 v2, int frame_width, int frame_height, int color);
+void set_pixel_off(uint8_t* data, int byteIndex, int columnIndex);
 
-void renderer_draw_line_by_triangle(uint8_t* data, Triangle triangle, int frame_width, int frame_height, int color);
+int calculate_byte_index(int rowIndex, int columnIndex);
 
-void renderer_draw_fill(
+void renderer_draw_line_occluded(
         uint8_t* frame,
-        int x1, int y1,
-        int x2, int y2,
-        int x3, int y3,
+        int x1, int y1, float z1,
+        int x2, int y2, float z2,
         int frame_width, int frame_height,
-        float brightness
+        int color,
+        const Occlusion* occlusion
 );
 
-void renderer_draw_fill_by_triangle(
+void renderer_draw_segment(
+        uint8_t* data,
+        Vector3 v1, Vector3 v2,
+        int frame_width, int frame_height,
+        int color,
+        const Occlusion* occlusion
+);
+
+void renderer_draw_line_by_triangle(
         uint8_t* data,
         Triangle triangle, int frame_width, int frame_height,
-        float brightness
+        int color, const Occlusion* occlusion
+);
+
+void renderer_draw_triangle(
+        Renderer* renderer,
+        uint8_t* data,
+        Triangle triangle,
+        const DitherPattern* pattern,
+        const Occlusion* occlusion
 );
 
 void renderer_draw_normal(Renderer* renderer, uint8_t* data, Triangle triangle, int color);
 
 Vector3 renderer_transform_to_2d_space(Renderer* renderer, Vector3* vector);
 
+Vector3 renderer_project_clip_vertex(Renderer* renderer, const Vector4* vertex);
+
+
+void renderer_draw_clipped_triangle(
+        Renderer* renderer,
+        uint8_t* data,
+        const Vector4 clipVertices[3],
+        int planes,
+        const DitherPattern* pattern,
+        int color,
+        const Occlusion* occlusion
+);
+
+float renderer_projected_radius(const Renderer* renderer, const BoundingSphere* bounds);
+
+LodSelection renderer_select_lod(const Renderer* renderer, const SceneNode* node);
+
+void renderer_count_node(void* context, const SceneNode* node);
+
+int renderer_alloc_frame(Renderer* renderer, const Scene* scene);
+
+void renderer_gather_mesh(Renderer* renderer, const Mesh* mesh, const Matrix4x3* modelMatrix, float fade, int fadeInvert);
+
+void renderer_gather_node(void* context, const SceneNode* node);
+
+void renderer_draw_triangles(Renderer* renderer, uint8_t* data);
+
+void renderer_mark_dirty(Renderer* renderer, const Vector3* points, int count);
+
 #if !defined(min)
 int min(int a, int b);
 #endif
@@ -65,20 +143,57 @@ int max(int a, int b);
  */
 
 Renderer* renderer_create(PlaydateAPI* api, int refreshRate, int scale) {
-    Renderer* renderer = malloc(sizeof(Renderer));
+    Renderer* renderer = memory_alloc(sizeof(Renderer));
     renderer->refreshRate = refreshRate;
     renderer->scale = scale;
     renderer->rows = LCD_ROWS / scale;
     renderer->columns = LCD_COLUMNS / scale;
     renderer->directionalLight = (Vector3) {.x = 1.0f, .y = -1.0f, .z = -1.0f};
     renderer->cameraPosition = (Vector3) {.x = 0.0f, .y = 0.0f, .z = 0.0f};
+    renderer->nearPlane = 0.1f;
+    renderer->farPlane = 100.0f;
     renderer->projectionMatrix = matrix4X4_projection(
             60,
             (float) renderer->columns / (float) renderer->rows,
-            0.1f,
-            100.0f
+            renderer->nearPlane,
+            renderer->farPlane
     );
+    renderer->clipVolume = clip_volume(renderer->nearPlane, renderer->columns, renderer->rows);
+
+    // Projected depth is m22 + m32 / viewDepth, which is still linear in screen space after the remap
+    float projectedNear = renderer->projectionMatrix.m[2][2] + renderer->projectionMatrix.m[3][2] / renderer->nearPlane;
+    float projectedFar = renderer->projectionMatrix.m[2][2] + renderer->projectionMatrix.m[3][2] / renderer->farPlane;
+    renderer->depthOffset = -projectedNear;
+    renderer->depthScale = 1.0f / (projectedFar - projectedNear);
+
+    // The camera only moves, view space is world space shifted by the camera position
+    renderer->viewMatrix = matrix4x3_translation(vector3_scalar_multiply(renderer->cameraPosition, -1.0f));
+
+    Matrix4x4 view = matrix4x3_to_matrix4x4(&renderer->viewMatrix);
+    Matrix4x4 viewProjection;
+    matrix4x4_multiply(&view, &renderer->projectionMatrix, &viewProjection);
+    renderer->frustum = frustum_from_matrix(&viewProjection, renderer->nearPlane, renderer->farPlane);
+
     renderer->fontpath = "/System/Fonts/Roobert-10-Bold.pft";
+    renderer->fillEngine = FILL_ENGINE_SCANLINE;
+    renderer->wireframe = 0;
+    renderer->lodFade = RENDERER_LOD_FADE;
+    renderer->lodBias = 1.0f;
+    renderer->bayerSize = BAYER_8;
+    arena_init(&renderer->frameArena, RENDERER_FRAME_ARENA_SIZE);
+    renderer->clipVertices = NULL;
+    renderer->screenVertices = NULL;
+    renderer->outcodes = NULL;
+    renderer->vertexUsed = NULL;
+    renderer->visibleFaces = NULL;
+    renderer->usedVertices = NULL;
+    renderer->usedX = NULL;
+    renderer->usedY = NULL;
+    renderer->usedZ = NULL;
+    renderer->frameVertexCount = 0;
+    renderer->drawCount = 0;
+    renderer->drawTriangles = NULL;
+    depth_sort_init(&renderer->depthSort);
     renderer_init(renderer, api);
 
     return renderer;
@@ -107,122 +222,599 @@ void renderer_init(Renderer* renderer, PlaydateAPI* api) {
     if (font == NULL)
         api->system->error("%s:%i Couldn't load font %s: %s", __FILE__, __LINE__, renderer->fontpath, err);
 
-    mesh = create_cube_mesh();
+    renderer->dither = dither_create_bayer(renderer->bayerSize);
+
+    if (renderer->dither == NULL)
+        api->system->error("%s:%i Couldn't create the dither table", __FILE__, __LINE__);
+
+    dirty_region_init(&renderer->previousDirty, renderer->rows, renderer->columns);
+    dirty_region_init(&renderer->currentDirty, renderer->rows, renderer->columns);
+
+    span_buffer_init(&renderer->coverage, renderer->rows, renderer->columns);
+    depth_buffer_init(&renderer->depth, renderer->rows, renderer->columns);
+
+#ifdef RENDERER_PROFILE
+    profiler_init(&renderer->profiler, api);
+#ifdef RENDERER_PROFILE_CSV
+    profiler_open_csv(&renderer->profiler, RENDERER_PROFILE_CSV);
+#endif
+#endif
+}
+
+/**
+ * @brief Draws all visible nodes of a scene into the frame.
+ *
+ * The scene is brought up to date first, then the triangles of every node whose bounds intersect the view
+ * frustum are gathered and drawn sorted by depth. Nodes outside of the frustum are skipped before any of their
+ * vertices are transformed.
+ *
+ * @param renderer Pointer to the Renderer struct.
+ * @param api Pointer to the PlaydateAPI object.
+ * @param scene The scene to draw.
+ * @return 1 if the scene was drawn, 0 if the frame buffers of the pipeline couldn't be allocated and the frame
+ * was only cleared.
+ */
+
+int renderer_draw(Renderer* renderer, PlaydateAPI* api, Scene* scene) {
+#ifdef RENDERER_PROFILE
+    profiler_begin_frame(&renderer->profiler);
+#endif
+
+    uint8_t* data = api->graphics->getFrame();
+
+    // Only clear what the previous frame has drawn
+    dirty_region_clear_frame(&renderer->previousDirty, data);
+    dirty_region_reset(&renderer->currentDirty);
+
+    scene_update(scene);
+    int drawn = renderer_alloc_frame(renderer, scene);
+
+    // Out of memory, the frame is skipped
+    if (drawn) {
+        renderer->frameVertexCount = 0;
+        renderer->drawCount = 0;
+
+        scene_visit_visible(scene, &renderer->frustum, renderer_gather_node, renderer);
+        renderer_draw_triangles(renderer, data);
+    }
+
+    // Push the rows that were cleared or drawn to the display
+    dirty_region_mark_rows(&renderer->previousDirty, &renderer->currentDirty, api->graphics->markUpdatedRows);
+
+    DirtyRegion region = renderer->currentDirty;
+    renderer->currentDirty = renderer->previousDirty;
+    renderer->previousDirty = region;
+
+#ifdef RENDERER_PROFILE
+    profiler_end_frame(&renderer->profiler);
+#endif
+
+    return drawn;
 }
 
-float last_angle = 400.0f;
+/**
+ * @brief Draws a scene like renderer_draw, or copies the frame of the same key out of a frame cache.
+ *
+ * The caller guarantees that the image only depends on the key. On a miss the scene is drawn and the frame
+ * is stored under the key, on a hit nothing is transformed or rasterized.
+ *
+ * @param renderer Pointer to the Renderer struct.
+ * @param api Pointer to the PlaydateAPI object.
+ * @param scene The scene to draw on a miss.
+ * @param cache The frames drawn so far.
+ * @param key The key of the frame.
+ * @return 1 if the frame came out of the cache, 0 if it was drawn.
+ */
+
+int renderer_draw_cached(Renderer* renderer, PlaydateAPI* api, Scene* scene, FrameCache* cache, int key) {
+    const FrameCacheEntry* entry = frame_cache_find(cache, key);
 
-void renderer_draw(Renderer* renderer, PlaydateAPI* api) {
-    const struct playdate_graphics* graphics = api->graphics;
-    float angle = api->system->getCrankAngle();
-    if (angle == last_angle)
+    if (entry == NULL) {
+        // A skipped frame isn't kept, the key is drawn again next time
+        if (renderer_draw(renderer, api, scene))
+            frame_cache_store(cache, key, api->graphics->getFrame());
+        return 0;
+    }
+
+    // Decoding overwrites the whole frame, the previous frame is cleared with it
+    frame_cache_decode(cache, entry, api->graphics->getFrame(), &renderer->currentDirty);
+    dirty_region_mark_rows(&renderer->previousDirty, &renderer->currentDirty, api->graphics->markUpdatedRows);
+
+    DirtyRegion drawn = renderer->currentDirty;
+    renderer->currentDirty = renderer->previousDirty;
+    renderer->previousDirty = drawn;
+
+    return 1;
+}
+
+/**
+ * @brief Changes the display scale and resizes every buffer that covers the frame.
+ *
+ * The frame is cleared, since nothing drawn at the old scale lines up with the new one.
+ *
+ * @param renderer Pointer to the Renderer struct.
+ * @param api Pointer to the PlaydateAPI object.
+ * @param scale The new display scale.
+ */
+
+void renderer_set_scale(Renderer* renderer, PlaydateAPI* api, int scale) {
+    if (scale == renderer->scale)
         return;
-    last_angle = angle;
 
-    float theta_radians = angle * PI / 180.0f;
+    renderer->scale = scale;
+    renderer->rows = LCD_ROWS / scale;
+    renderer->columns = LCD_COLUMNS / scale;
+    renderer->clipVolume = clip_volume(renderer->nearPlane, renderer->columns, renderer->rows);
+    api->display->setScale(scale);
 
-    Matrix4x4 rotationX = {
-            .m = {
-                    {1.0f, 0.0f,                0.0f,                 0.0f},
-                    {0.0f, cosf(theta_radians), -sinf(theta_radians), 0.0f},
-                    {0.0f, sinf(theta_radians), cosf(theta_radians),  0.0f},
-                    {0.0f, 0.0f,                0.0f,                 1.0f}
-            }
-    };
+    dirty_region_destroy(&renderer->previousDirty);
+    dirty_region_destroy(&renderer->currentDirty);
+    span_buffer_destroy(&renderer->coverage);
+    depth_buffer_destroy(&renderer->depth);
 
-    Matrix4x4 rotationZ = {
-            .m = {
-                    {cosf(theta_radians), -sinf(theta_radians), 0.0f, 0.0f},
-                    {sinf(theta_radians), cosf(theta_radians),  0.0f, 0.0f},
-                    {0.0f,                0.0f,                 1.0f, 0.0f},
-                    {0.0f,                0.0f,                 0.0f, 1.0f}
-            }
-    };
+    dirty_region_init(&renderer->previousDirty, renderer->rows, renderer->columns);
+    dirty_region_init(&renderer->currentDirty, renderer->rows, renderer->columns);
+    span_buffer_init(&renderer->coverage, renderer->rows, renderer->columns);
+    depth_buffer_init(&renderer->depth, renderer->rows, renderer->columns);
 
-    Matrix4x4 rotationY = {
-            .m = {
-                    {cosf(theta_radians),  0.0f, sinf(theta_radians), 0.0f},
-                    {0.0f,                 1.0f, 0.0f,                0.0f},
-                    {-sinf(theta_radians), 0.0f, cosf(theta_radians), 0.0f},
-                    {0.0f,                 0.0f, 0.0f,                1.0f}
-            }
-    };
+    api->graphics->clear(kColorWhite);
+    dirty_region_reset(&renderer->previousDirty);
+}
 
-    Matrix4x4 rotation;
-    matrix4x4_multiply(&rotationX, &rotationZ, &rotation);
-    matrix4x4_multiply(&rotation, &rotationY, &rotation);
+/**
+ * @brief Replaces the dither table with one of another Bayer matrix size.
+ *
+ * The new table is created first, if that fails the current one stays in use.
+ *
+ * @param renderer Pointer to the Renderer struct.
+ * @param bayerSize BAYER_2, BAYER_4 or BAYER_8.
+ */
+
+void renderer_set_dither(Renderer* renderer, int bayerSize) {
+    if (bayerSize == renderer->bayerSize)
+        return;
+
+    DitherTable* dither = dither_create_bayer(bayerSize);
+    if (dither == NULL)
+        return;
+
+    dither_destroy(renderer->dither);
+    renderer->bayerSize = bayerSize;
+    renderer->dither = dither;
+}
+
+/**
+ * @brief Applies the settings of a quality level.
+ *
+ * @param renderer Pointer to the Renderer struct.
+ * @param api Pointer to the PlaydateAPI object.
+ * @param quality The settings to draw with.
+ */
 
-    uint8_t* data = graphics->getFrame();
+void renderer_set_quality(Renderer* renderer, PlaydateAPI* api, const QualityLevel* quality) {
+    renderer_set_scale(renderer, api, quality->scale);
+    renderer_set_dither(renderer, quality->bayerSize);
+    renderer->wireframe = quality->wireframe;
+    renderer->lodBias = quality->lodBias;
+}
+
+#ifdef RENDERER_PROFILE
+
+/**
+ * @brief Draws the profiler overlay into the bottom left corner of the frame with the loaded font.
+ *
+ * The overlay is added to the dirty region of the last frame, so the next frame clears it.
+ *
+ * @param renderer Pointer to the Renderer struct.
+ */
+
+void renderer_draw_profiler(Renderer* renderer) {
+    int top = renderer->rows - PROFILER_OVERLAY_HEIGHT;
 
-    graphics->clear(kColorWhite);
+    profiler_draw_overlay(&renderer->profiler, font, 0, top);
+    dirty_region_add_rect(&renderer->previousDirty, 0, top, PROFILER_OVERLAY_WIDTH - 1, renderer->rows - 1);
+}
 
-    // For each triangle in mesh
-    for (int i = 0; i < mesh.triangleCount; i++) {
-        Triangle triangleTranslated = mesh.triangles[i];
-        Triangle triangleRotate = mesh.triangles[i];
-        Triangle triangleProjected = mesh.triangles[i];
+#endif
 
-        // Apply rotation to triangle
-        for (int p = 0; p < 3; p++) {
-            vector3_multiply_matrix4x4(
-                    &mesh.triangles[i].points[p],
-                    &triangleRotate.points[p],
-                    &rotation
-            );
+/**
+ * @brief Radius in pixels of a world space sphere on the screen.
+ *
+ * @param renderer Pointer to the Renderer struct.
+ * @param bounds The sphere.
+ * @return The projected radius, FLT_MAX if the sphere reaches the camera plane, including spheres behind the camera.
+ */
+
+float renderer_projected_radius(const Renderer* renderer, const BoundingSphere* bounds) {
+    BoundingSphere view = bounding_sphere_transform(*bounds, &renderer->viewMatrix);
+    if (view.center.z <= view.radius)
+        return FLT_MAX;
+
+    // Clip-space w is the view depth, the projection scales y by m11 before the divide
+    return view.radius * renderer->projectionMatrix.m[1][1] * 0.5f * (float) renderer->rows / view.center.z;
+}
+
+/**
+ * @brief Chooses the level of detail of a node from the projected radius of its bounds.
+ *
+ * The chain is followed while the radius, scaled by the level of detail bias, is below the switch radius of a
+ * level. Just above a switch radius the next coarser level fades in through a screen door, unless the fill engine
+ * resolves visibility per pixel, which a door would break, or only outlines are drawn.
+ *
+ * @param renderer Pointer to the Renderer struct.
+ * @param node A visible node with a mesh.
+ * @return The levels to draw.
+ */
+
+LodSelection renderer_select_lod(const Renderer* renderer, const SceneNode* node) {
+    LodSelection selection = {.mesh = node->mesh, .fadeMesh = NULL, .fade = 1.0f};
+    if (node->mesh->lod == NULL)
+        return selection;
+
+    int canFade = renderer->lodFade > 0.0f && !renderer->wireframe &&
+                  (renderer->fillEngine == FILL_ENGINE_SCANLINE || renderer->fillEngine == FILL_ENGINE_HALF_SPACE);
+    float band = canFade ? 1.0f + renderer->lodFade : 1.0f;
+    float radius = renderer_projected_radius(renderer, &node->worldBounds) * renderer->lodBias;
+
+    while (selection.mesh->lod != NULL && radius < selection.mesh->lodRadius * band) {
+        if (radius < selection.mesh->lodRadius) {
+            selection.mesh = selection.mesh->lod;
+            continue;
         }
 
-        triangleTranslated = triangleRotate;
+        selection.fadeMesh = selection.mesh->lod;
+        selection.fade = (radius - selection.mesh->lodRadius) / (selection.mesh->lodRadius * renderer->lodFade);
+        break;
+    }
 
-        // Move triangle away from camera
-        for (int p = 0; p < 3; p++) {
-            triangleTranslated.points[p].z += 3.0f;
+    return selection;
+}
+
+void renderer_count_node(void* context, const SceneNode* node) {
+    FrameGeometry* geometry = context;
+    LodSelection selection = renderer_select_lod(geometry->renderer, node);
+
+    geometry->vertexCount += selection.mesh->vertexCount;
+    geometry->triangleCount += selection.mesh->triangleCount;
+    geometry->largestMesh = max(geometry->largestMesh, selection.mesh->triangleCount);
+    geometry->largestVertices = max(geometry->largestVertices, selection.mesh->vertexCount);
+
+    if (selection.fadeMesh != NULL) {
+        geometry->vertexCount += selection.fadeMesh->vertexCount;
+        geometry->triangleCount += selection.fadeMesh->triangleCount;
+        geometry->largestMesh = max(geometry->largestMesh, selection.fadeMesh->triangleCount);
+        geometry->largestVertices = max(geometry->largestVertices, selection.fadeMesh->vertexCount);
+    }
+}
+
+/**
+ * @brief Takes the per-frame buffers of the pipeline from the frame arena.
+ *
+ * The visible nodes are counted first, so every buffer is taken once at its final size and nothing is grown
+ * while meshes are gathered. The arena only reallocates when a frame shows more geometry than any before.
+ *
+ * @param renderer Pointer to the Renderer struct.
+ * @param scene The scene to draw, must be up to date.
+ * @return 1 on success, 0 if the frame arena couldn't grow and nothing can be drawn.
+ */
+
+int renderer_alloc_frame(Renderer* renderer, const Scene* scene) {
+    FrameGeometry geometry = {renderer, 0, 0, 0, 0};
+    scene_visit_visible(scene, &renderer->frustum, renderer_count_node, &geometry);
+
+    int vertices = geometry.vertexCount;
+    int triangles = geometry.triangleCount;
+    size_t size = ARENA_SIZE(sizeof(Vector4) * vertices)
+                  + ARENA_SIZE(sizeof(Vector3) * vertices)
+                  + ARENA_SIZE(sizeof(uint16_t) * vertices)
+                  + ARENA_SIZE(sizeof(uint8_t) * vertices)
+                  + ARENA_SIZE(sizeof(int) * geometry.largestMesh)
+                  + ARENA_SIZE(sizeof(int) * geometry.largestVertices)
+                  + 3 * ARENA_SIZE(sizeof(float) * geometry.largestVertices)
+                  + ARENA_SIZE(sizeof(DrawTriangle) * triangles)
+                  + depth_sort_arena_size(triangles);
+
+    arena_reset(&renderer->frameArena);
+    if (!arena_reserve(&renderer->frameArena, size))
+        return 0;
+
+    renderer->clipVertices = arena_alloc(&renderer->frameArena, sizeof(Vector4) * vertices);
+    renderer->screenVertices = arena_alloc(&renderer->frameArena, sizeof(Vector3) * vertices);
+    renderer->outcodes = arena_alloc(&renderer->frameArena, sizeof(uint16_t) * vertices);
+    renderer->vertexUsed = arena_alloc(&renderer->frameArena, sizeof(uint8_t) * vertices);
+    renderer->visibleFaces = arena_alloc(&renderer->frameArena, sizeof(int) * geometry.largestMesh);
+    renderer->usedVertices = arena_alloc(&renderer->frameArena, sizeof(int) * geometry.largestVertices);
+    renderer->usedX = arena_alloc(&renderer->frameArena, sizeof(float) * geometry.largestVertices);
+    renderer->usedY = arena_alloc(&renderer->frameArena, sizeof(float) * geometry.largestVertices);
+    renderer->usedZ = arena_alloc(&renderer->frameArena, sizeof(float) * geometry.largestVertices);
+    renderer->drawTriangles = arena_alloc(&renderer->frameArena, sizeof(DrawTriangle) * triangles);
+    int sorted = depth_sort_alloc(&renderer->depthSort, &renderer->frameArena, triangles);
+
+    return sorted && renderer->clipVertices != NULL && renderer->screenVertices != NULL && renderer->outcodes != NULL &&
+           renderer->vertexUsed != NULL && renderer->visibleFaces != NULL && renderer->usedVertices != NULL &&
+           renderer->usedX != NULL && renderer->usedY != NULL && renderer->usedZ != NULL &&
+           renderer->drawTriangles != NULL;
+}
+
+void renderer_gather_node(void* context, const SceneNode* node) {
+    LodSelection selection = renderer_select_lod(context, node);
+    renderer_gather_mesh(context, selection.mesh, &node->worldMatrix, selection.fade, 0);
+
+    if (selection.fadeMesh != NULL)
+        renderer_gather_mesh(context, selection.fadeMesh, &node->worldMatrix, selection.fade, 1);
+}
+
+/**
+ * @brief Culls and transforms a single mesh and adds its visible triangles to the draw list of the frame.
+ *
+ * Backfaces are culled in object space before anything is transformed: the camera is moved into the
+ * object space of the mesh once and tested against the precomputed face planes. Only vertices used by
+ * the remaining faces are transformed, gathered as structure-of-arrays and moved into view space by a single
+ * transform_points_affine batch. Every triangle gets a depth key from the average view depth of its vertices.
+ *
+ * @param renderer Pointer to the Renderer struct.
+ * @param mesh The mesh to draw.
+ * @param modelMatrix Transformation from object space to world space.
+ * @param fade Share of the pixels written, 1 outside of a level of detail cross-fade.
+ * @param fadeInvert Write the pixels a mesh with the same fade leaves out instead.
+ */
+
+void renderer_gather_mesh(Renderer* renderer, const Mesh* mesh, const Matrix4x3* modelMatrix, float fade, int fadeInvert) {
+    // Concatenate once, so every vertex goes from object space to view space in a single multiply
+    Matrix4x3 modelView;
+    matrix4x3_multiply(modelMatrix, &renderer->viewMatrix, &modelView);
+
+    // Face normals are rotated into world space for lighting
+    Matrix4x3 normalMatrix;
+    int unitNormals = matrix4x3_normal_matrix(modelMatrix, &normalMatrix);
+
+    // The camera sits at the origin of view space
+    Matrix4x3 viewModel;
+    if (!matrix4x3_inverse(&modelView, &viewModel))
+        return;
+
+    Vector3 camera = {viewModel.m[3][0], viewModel.m[3][1], viewModel.m[3][2]};
+
+    // The vertices of all meshes of the frame share one buffer, so triangles can be drawn in any order
+    int base = renderer->frameVertexCount;
+    memset(renderer->vertexUsed + base, 0, mesh->vertexCount);
+    renderer->frameVertexCount += mesh->vertexCount;
+
+    uint8_t* vertexUsed = renderer->vertexUsed + base;
+    Vector4* clipVertices = renderer->clipVertices + base;
+    Vector3* screenVertices = renderer->screenVertices + base;
+    uint16_t* outcodes = renderer->outcodes + base;
+
+    int faceCount = 0;
+
+    PROFILE_COUNT(&renderer->profiler, PROFILE_COUNTER_SUBMITTED, mesh->triangleCount);
+    PROFILE_BEGIN(&renderer->profiler, PROFILE_STAGE_CULL);
+
+    for (int i = 0; i < mesh->triangleCount; i++) {
+        // Camera on the back side of the face plane
+        if (vector3_dot_product(mesh->normals[i], camera) + mesh->planeDistances[i] <= 0.0f)
+            continue;
+
+        const uint16_t* indices = &mesh->indices[i * 3];
+        vertexUsed[indices[0]] = 1;
+        vertexUsed[indices[1]] = 1;
+        vertexUsed[indices[2]] = 1;
+        renderer->visibleFaces[faceCount++] = i;
+    }
+
+    PROFILE_END(&renderer->profiler, PROFILE_STAGE_CULL);
+    PROFILE_COUNT(&renderer->profiler, PROFILE_COUNTER_CULLED, mesh->triangleCount - faceCount);
+    PROFILE_BEGIN(&renderer->profiler, PROFILE_STAGE_TRANSFORM);
+
+    // Every unique vertex of a front face is transformed once, as structure-of-arrays for the batch transform
+    int* usedVertices = renderer->usedVertices;
+    float* x = renderer->usedX;
+    float* y = renderer->usedY;
+    float* z = renderer->usedZ;
+    int usedCount = 0;
+
+    for (int v = 0; v < mesh->vertexCount; v++) {
+        if (!vertexUsed[v])
+            continue;
+
+        usedVertices[usedCount] = v;
+        x[usedCount] = mesh->vertices[v].x;
+        y[usedCount] = mesh->vertices[v].y;
+        z[usedCount] = mesh->vertices[v].z;
+        usedCount++;
+    }
+
+    // The model view transformation is affine, the batch needs no divide
+    transform_points_affine(&modelView, x, y, z, x, y, z, usedCount);
+
+    // The projection stays a separate sparse step, clip-space w is the view depth
+    for (int u = 0; u < usedCount; u++) {
+        int v = usedVertices[u];
+        Vector3 viewVertex = {x[u], y[u], z[u]};
+        Vector4* clipVertex = &clipVertices[v];
+
+        vector3_multiply_projection(&viewVertex, clipVertex, &renderer->projectionMatrix);
+        outcodes[v] = (uint16_t) clip_outcode(&renderer->clipVolume, clipVertex);
+
+        // Vertices behind the near plane are only ever used through the clipper
+        if (!(outcodes[v] & CLIP_NEAR))
+            screenVertices[v] = renderer_project_clip_vertex(renderer, clipVertex);
+    }
+
+    PROFILE_END(&renderer->profiler, PROFILE_STAGE_TRANSFORM);
+
+    // For each front facing triangle in mesh
+    for (int f = 0; f < faceCount; f++) {
+        int i = renderer->visibleFaces[f];
+        const uint16_t* indices = &mesh->indices[i * 3];
+
+        // All vertices outside of the same plane, nothing of the triangle can be visible
+        if (outcodes[indices[0]] & outcodes[indices[1]] & outcodes[indices[2]] & CLIP_REJECT_PLANES) {
+            PROFILE_COUNT(&renderer->profiler, PROFILE_COUNTER_CULLED, 1);
+            continue;
         }
 
-        Vector3 normal = triangle_normal(&triangleTranslated);
+        Vector3 normal;
+        vector3_rotate_matrix4x3(&mesh->normals[i], &normal, &normalMatrix);
+        if (!unitNormals)
+            normal = vector3_normalize(normal);
+
+        // Clip-space w is the view depth
+        float depth = (clipVertices[indices[0]].w + clipVertices[indices[1]].w + clipVertices[indices[2]].w) / 3.0f;
+
+        int draw = renderer->drawCount++;
+        renderer->drawTriangles[draw] = (DrawTriangle) {
+                .vertices = {base + indices[0], base + indices[1], base + indices[2]},
+                .brightness = (vector3_dot_product(normal, renderer->directionalLight) + 1.0f) / 2.0f,
+                .fade = fade,
+                .fadeInvert = fadeInvert
+        };
+        renderer->depthSort.keys[draw] = depth_sort_key(depth, renderer->nearPlane, renderer->farPlane);
+    }
+}
+
+/**
+ * @brief Draws the gathered triangles of the frame sorted by depth.
+ *
+ * Triangles are painted back to front. With FILL_ENGINE_SPAN_BUFFER they are drawn front to back instead and
+ * every triangle only fills the pixels no nearer triangle has covered, which stops as soon as the frame is full.
+ * FILL_ENGINE_DEPTH_BUFFER also draws front to back, so the depth buffer rejects hidden triangles early, but
+ * resolves visibility per pixel and also handles triangles the depth sort cannot order.
+ *
+ * @param renderer Pointer to the Renderer struct.
+ * @param data Pointer to the frame buffer.
+ */
+
+void renderer_draw_triangles(Renderer* renderer, uint8_t* data) {
+    PROFILE_BEGIN(&renderer->profiler, PROFILE_STAGE_SORT);
+    const int* order = depth_sort_order(&renderer->depthSort, renderer->drawCount);
+    PROFILE_END(&renderer->profiler, PROFILE_STAGE_SORT);
+
+    Occlusion occlusion = {.coverage = NULL, .depth = NULL};
+    if (renderer->fillEngine == FILL_ENGINE_SPAN_BUFFER) {
+        occlusion.coverage = &renderer->coverage;
+        span_buffer_reset(occlusion.coverage);
+    } else if (renderer->fillEngine == FILL_ENGINE_DEPTH_BUFFER) {
+        occlusion.depth = &renderer->depth;
+        depth_buffer_clear(occlusion.depth);
+    }
+
+    int frontToBack = occlusion.coverage != NULL || occlusion.depth != NULL;
 
-        float dot = vector3_dot_product(
-                normal,
-                vector3_subtract(
-                        triangleTranslated.points[0],
-                        renderer->cameraPosition
-                )
-        );
+    for (int d = 0; d < renderer->drawCount; d++) {
+        if (occlusion.coverage != NULL && span_buffer_is_full(occlusion.coverage))
+            break;
 
-        if (dot >= 0) {
+        int index = frontToBack ? order[renderer->drawCount - 1 - d] : order[d];
+        const DrawTriangle* draw = &renderer->drawTriangles[index];
+        const int* vertices = draw->vertices;
+
+        PROFILE_COUNT(&renderer->profiler, PROFILE_COUNTER_DRAWN, 1);
+
+        DitherPattern pattern = dither_pattern(renderer->dither, draw->brightness);
+        int lineColor = draw->brightness > 0.2f || renderer->wireframe ? kColorBlack : kColorWhite;
+
+        if (draw->fade < 1.0f) {
+            dither_set_door(&pattern, renderer->dither, draw->fade, draw->fadeInvert);
+
+            // Lines can't be faded, only the level covering most pixels is outlined
+            if ((draw->fadeInvert ? 1.0f - draw->fade : draw->fade) < 0.5f)
+                lineColor = kColorClear;
+        }
+
+        int outcodes = renderer->outcodes[vertices[0]] | renderer->outcodes[vertices[1]] | renderer->outcodes[vertices[2]];
+        int clipPlanes = outcodes & CLIP_CLIP_PLANES;
+        if (clipPlanes) {
+            const Vector4 clipVertices[3] = {
+                    renderer->clipVertices[vertices[0]],
+                    renderer->clipVertices[vertices[1]],
+                    renderer->clipVertices[vertices[2]]
+            };
+
+            renderer_draw_clipped_triangle(renderer, data, clipVertices, clipPlanes, &pattern, lineColor, &occlusion);
             continue;
         }
 
-        // Project triangle from 3D to 2D
-        for (int p = 0; p < 3; p++) {
-            vector3_multiply_matrix4x4(
-                    &triangleTranslated.points[p],
-                    &triangleProjected.points[p],
-                    &renderer->projectionMatrix
-            );
+        Triangle triangleProjected = {
+                .points = {
+                        renderer->screenVertices[vertices[0]],
+                        renderer->screenVertices[vertices[1]],
+                        renderer->screenVertices[vertices[2]]
+                }
+        };
+
+        renderer_mark_dirty(renderer, triangleProjected.points, 3);
 
-            renderer_transform_to_2d_space(renderer, &triangleProjected.points[p]);
+        // Front to back the outline has to claim its pixels before the fill, otherwise the fill would hide it
+        if (occlusion.coverage != NULL) {
+            PROFILE_BEGIN(&renderer->profiler, PROFILE_STAGE_LINE);
+            renderer_draw_line_by_triangle(data, triangleProjected, renderer->columns, renderer->rows, lineColor, &occlusion);
+            PROFILE_END(&renderer->profiler, PROFILE_STAGE_LINE);
         }
 
-        float brightness = (vector3_dot_product(normal, renderer->directionalLight) + 1.0f) / 2.0f;
+        PROFILE_BEGIN(&renderer->profiler, PROFILE_STAGE_FILL);
+        renderer_draw_triangle(renderer, data, triangleProjected, &pattern, &occlusion);
+        PROFILE_END(&renderer->profiler, PROFILE_STAGE_FILL);
 
-        renderer_draw_fill_by_triangle(
-                data,
-                triangleProjected,
-                renderer->columns,
-                renderer->rows,
-                brightness
-        );
+        if (occlusion.coverage == NULL && lineColor != kColorClear) {
+            PROFILE_BEGIN(&renderer->profiler, PROFILE_STAGE_LINE);
+            renderer_draw_line_by_triangle(data, triangleProjected, renderer->columns, renderer->rows, lineColor, &occlusion);
+            PROFILE_END(&renderer->profiler, PROFILE_STAGE_LINE);
+        }
+    }
+}
+
+/**
+ * @brief Returns the area of a screen-space triangle in pixels.
+ */
+
+static inline float renderer_triangle_area(const Triangle* triangle) {
+    const Vector3* p = triangle->points;
+    return 0.5f * fabsf((p[1].x - p[0].x) * (p[2].y - p[0].y) - (p[1].y - p[0].y) * (p[2].x - p[0].x));
+}
 
-        renderer_draw_line_by_triangle(
+/**
+ * @brief Fills a screen-space triangle with the fill engine of the renderer, nothing in wireframe mode.
+ *
+ * @param renderer Pointer to the Renderer struct.
+ * @param data Pointer to the frame buffer.
+ * @param triangle The screen space triangle.
+ * @param pattern The dither pattern of the triangle brightness.
+ * @param occlusion The buffers of the fill engine, all NULL when drawing back to front.
+ */
+
+void renderer_draw_triangle(
+        Renderer* renderer,
+        uint8_t* data,
+        Triangle triangle,
+        const DitherPattern* pattern,
+        const Occlusion* occlusion
+) {
+    if (renderer->wireframe)
+        return;
+
+    PROFILE_COUNT(&renderer->profiler, PROFILE_COUNTER_AREA, (int) renderer_triangle_area(&triangle));
+
+    if (occlusion->coverage != NULL) {
+        scanline_fill_triangle_covered(data, &triangle, renderer->columns, renderer->rows, pattern, occlusion->coverage);
+        return;
+    }
+
+    if (occlusion->depth != NULL) {
+        renderer_draw_fill_depth(
                 data,
-                triangleProjected,
+                (int) roundf(triangle.points[0].x), (int) roundf(triangle.points[0].y), triangle.points[0].z,
+                (int) roundf(triangle.points[1].x), (int) roundf(triangle.points[1].y), triangle.points[1].z,
+                (int) roundf(triangle.points[2].x), (int) roundf(triangle.points[2].y), triangle.points[2].z,
                 renderer->columns,
                 renderer->rows,
-                brightness > 0.2f ? kColorBlack : kColorWhite
+                pattern,
+                occlusion->depth
         );
+        return;
     }
 
-    api->graphics->markUpdatedRows(0, renderer->rows - 1);
+    renderer_draw_fill_by_triangle(data, triangle, renderer->columns, renderer->rows, pattern, renderer->fillEngine);
 }
 
 #if !defined(min)
@@ -261,44 +853,11 @@ inline int max(int a, int b) {
 }
 #endif
 
-/**
- * Determines whether a point is inside a triangle.
- *
- * This function uses the Barycentric Coordinate System to check whether
- * the given point (x, y) is inside the triangle defined by the points
- * (x1, y1), (x2, y2), and (x3, y3).
- *
- * @param x1 The x-coordinate of the first point of the triangle.
- * @param y1 The y-coordinate of the first point of the triangle.
- * @param x2 The x-coordinate of the second point of the triangle.
- * @param y2 The y-coordinate of the second point of the triangle.
- * @param x3 The x-coordinate of the third point of the triangle.
- * @param y3 The y-coordinate of the third point of the triangle.
- * @param x The x-coordinate of the point to check.
- * @param y The y-coordinate of the point to check.
- *
- * @return True if the point is inside the triangle, false otherwise.
- */
-
-int point_in_triangle(int x1, int y1, int x2, int y2, int x3, int y3, int x, int y) {
-    // Barycentric Coordinate System
-    float denominator = ((y2 - y3) * (x1 - x3) + (x3 - x2) * (y1 - y3));
-    float alpha = ((y2 - y3) * (x - x3) + (x3 - x2) * (y - y3)) / denominator;
-    float beta = ((y3 - y1) * (x - x3) + (x1 - x3) * (y - y3)) / denominator;
-    float gamma = 1.0f - alpha - beta;
-
-    return alpha > 0 && beta > 0 && gamma > 0;
-}
-
 /**
  * @brief Renders a filled triangle onto a frame buffer.
  *
- * The function calculates the bounding box of the triangle defined by (x1, y1), (x2, y2),
- * and (x3, y3) vertices. It then calculates the Barycentric coordinates at the vertices.
- * If the triangle vertices are in clockwise order, the function flips the comparisons.
- * It iterates through each pixel within the bounding box and checks if the pixel is on or
- * inside all edges of the triangle using Barycentric coordinates.
- * If the pixel is inside the triangle, it sets it to off in the given frame buffer.
+ * The function hands the triangle to the half-space rasterizer, which writes the precomputed
+ * dither pattern bytes into the frame buffer.
  *
  * @param frame Pointer to the frame buffer
  * @param x1 X-coordinate of the first vertex of the triangle
@@ -309,6 +868,7 @@ int point_in_triangle(int x1, int y1, int x2, int y2, int x3, int y3, int x, int
  * @param y3 Y-coordinate of the third vertex of the triangle
  * @param frame_width Width of the frame buffer
  * @param frame_height Height of the frame buffer
+ * @param pattern The dither pattern of the triangle brightness
  */
 
 void renderer_draw_fill(
@@ -317,37 +877,43 @@ void renderer_draw_fill(
         int x2, int y2,
         int x3, int y3,
         int frame_width, int frame_height,
-        float brightness
+        const DitherPattern* pattern
 ) {
-    // Calculate bounding box of the triangle
-    int xMin = min(min(x1, x2), x3), xMax = max(max(x1, x2), x3);
-    int yMin = min(min(y1, y2), y3), yMax = max(max(y1, y2), y3);
-
-    xMin = max(xMin, 0);
-    xMax = min(xMax, frame_width - 1);
-
-    yMin = min(yMin, 0);
-    yMax = min(yMax, frame_height - 1);
-
-    for (int y = yMin; y <= yMax; y++) {
-        for (int x = xMin; x <= xMax; x++) {
-
-            // If p is on or inside all edges, render pixel
-            if (point_in_triangle(x1, y1, x2, y2, x3, y3, x, y)) {
-                if (x >= 0 && x < frame_width && y >= 0 && y < frame_height) {
-                    int rowIndex = y % frame_height;
-                    int columnIndex = x % frame_width;
-                    int byteIndex = calculate_byte_index(rowIndex, columnIndex);
+    rasterizer_fill_triangle(frame, x1, y1, x2, y2, x3, y3, frame_width, frame_height, pattern);
+}
 
-                    if ((int) (brightness * BAYER_MULTIPLIER) > bayer_value(rowIndex, columnIndex, BAYER_TABLE))
-                        set_pixel_on(frame, byteIndex, columnIndex);
-                    else
-                        set_pixel_off(frame, byteIndex, columnIndex);
+/**
+ * @brief Renders a filled triangle onto a frame buffer, hidden behind whatever the depth buffer holds.
+ *
+ * Only pixels nearer than the depth buffer are written, together with their new depth. Triangles and
+ * 8x8 blocks lying behind the farthest depth of the covered depth buffer tiles are skipped as a whole.
+ *
+ * @param frame Pointer to the frame buffer
+ * @param x1 X-coordinate of the first vertex of the triangle
+ * @param y1 Y-coordinate of the first vertex of the triangle
+ * @param z1 Normalized depth of the first vertex of the triangle
+ * @param x2 X-coordinate of the second vertex of the triangle
+ * @param y2 Y-coordinate of the second vertex of the triangle
+ * @param z2 Normalized depth of the second vertex of the triangle
+ * @param x3 X-coordinate of the third vertex of the triangle
+ * @param y3 Y-coordinate of the third vertex of the triangle
+ * @param z3 Normalized depth of the third vertex of the triangle
+ * @param frame_width Width of the frame buffer
+ * @param frame_height Height of the frame buffer
+ * @param pattern The dither pattern of the triangle brightness
+ * @param depth The depth buffer, the same size as the frame
+ */
 
-                }
-            }
-        }
-    }
+void renderer_draw_fill_depth(
+        uint8_t* frame,
+        int x1, int y1, float z1,
+        int x2, int y2, float z2,
+        int x3, int y3, float z3,
+        int frame_width, int frame_height,
+        const DitherPattern* pattern,
+        DepthBuffer* depth
+) {
+    rasterizer_fill_triangle_depth(frame, x1, y1, z1, x2, y2, z2, x3, y3, z3, frame_width, frame_height, pattern, depth);
 }
 
 /**
@@ -356,15 +922,26 @@ void renderer_draw_fill(
  *
  * This function takes a frame buffer data and a triangle, and fills the triangle in the frame buffer.
  * The triangle is defined by three points, and the frame buffer is defined by its dimensions.
+ * The scanline engine keeps the sub-pixel vertex positions, the half-space engine rounds them to whole pixels.
  *
  * @param data Pointer to the frame buffer data.
  * @param triangle The triangle that needs to be filled in the frame buffer.
  * @param frame_width Width of the frame buffer.
  * @param frame_height Height of the frame buffer.
+ * @param pattern The dither pattern of the triangle brightness.
+ * @param engine The fill engine used to rasterize the triangle.
  */
 
-void
-renderer_draw_fill_by_triangle(uint8_t* data, Triangle triangle, int frame_width, int frame_height, float brightness) {
+void renderer_draw_fill_by_triangle(
+        uint8_t* data,
+        Triangle triangle, int frame_width, int frame_height,
+        const DitherPattern* pattern, FillEngine engine
+) {
+    if (engine == FILL_ENGINE_SCANLINE || engine == FILL_ENGINE_SPAN_BUFFER) {
+        scanline_fill_triangle(data, &triangle, frame_width, frame_height, pattern);
+        return;
+    }
+
     renderer_draw_fill(
             data,
             (int) roundf(triangle.points[0].x), (int) roundf(triangle.points[0].y),
@@ -372,7 +949,7 @@ renderer_draw_fill_by_triangle(uint8_t* data, Triangle triangle, int frame_width
             (int) roundf(triangle.points[2].x), (int) roundf(triangle.points[2].y),
             frame_width,
             frame_height,
-            brightness
+            pattern
     );
 }
 
@@ -389,6 +966,56 @@ renderer_draw_fill_by_triangle(uint8_t* data, Triangle triangle, int frame_width
 */
 
 void renderer_draw_line(uint8_t* frame, int x1, int y1, int x2, int y2, int frame_width, int frame_height, int color) {
+    renderer_draw_line_occluded(frame, x1, y1, 0.0f, x2, y2, 0.0f, frame_width, frame_height, color, NULL);
+}
+
+/**
+ * @brief Depth tests a line pixel and keeps the nearer depth in the buffer.
+ *
+ * Lines pass slightly behind the buffer, so an outline is not hidden by the fill of its own triangle. Their
+ * depth is written slightly in front of them, which keeps both the fill and the outline of a farther triangle
+ * sharing the edge from drawing over it, the same as painting back to front. Tile depths are left as they are,
+ * they only get more conservative.
+ *
+ * @param depth The depth buffer.
+ * @param x X-coordinate of the pixel.
+ * @param y Y-coordinate of the pixel.
+ * @param z Depth of the line at the pixel in buffer units.
+ * @return 1 if the pixel is drawn, 0 if it is hidden.
+ */
+
+static inline int renderer_test_line_depth(DepthBuffer* depth, int x, int y, float z) {
+    uint16_t* pixel = &depth->depth[y * depth->columns + x];
+    if (z - RENDERER_LINE_DEPTH_BIAS > (float) *pixel)
+        return 0;
+
+    float front = z - 2 * RENDERER_LINE_DEPTH_BIAS;
+    uint16_t lineDepth = front <= 0.0f ? 0 : front >= (float) DEPTH_BUFFER_FAR ? DEPTH_BUFFER_FAR : (uint16_t) (front + 0.5f);
+    if (lineDepth < *pixel)
+        *pixel = lineDepth;
+
+    return 1;
+}
+
+/**
+ * @brief Draws a line like renderer_draw_line, but only the pixels not hidden by the occlusion buffers.
+ *
+ * With a span buffer only uncovered pixels are drawn and then covered. With a depth buffer the depth is
+ * interpolated along the line and tested by renderer_test_line_depth.
+ *
+ * @param z1 Normalized depth of the starting point.
+ * @param z2 Normalized depth of the ending point.
+ * @param occlusion The buffers hiding pixels, NULL to draw every pixel.
+ */
+
+void renderer_draw_line_occluded(
+        uint8_t* frame,
+        int x1, int y1, float z1,
+        int x2, int y2, float z2,
+        int frame_width, int frame_height,
+        int color,
+        const Occlusion* occlusion
+) {
     int dx = abs(x2 - x1);
     int dy = abs(y2 - y1);
     int sx = x1 < x2 ? 1 : -1;
@@ -396,8 +1023,18 @@ void renderer_draw_line(uint8_t* frame, int x1, int y1, int x2, int y2, int fram
     int err = (dx > dy ? dx : -dy) / 2;
     int e2;
 
+    SpanBuffer* coverage = occlusion != NULL ? occlusion->coverage : NULL;
+    DepthBuffer* depth = occlusion != NULL ? occlusion->depth : NULL;
+
+    // Every step moves along the major axis
+    int steps = dx > dy ? dx : dy;
+    float z = z1 * (float) DEPTH_BUFFER_FAR;
+    float stepZ = steps > 0 ? (z2 - z1) * (float) DEPTH_BUFFER_FAR / (float) steps : 0.0f;
+
     while (1) {
-        if (x1 >= 0 && x1 < frame_width && y1 >= 0 && y1 < frame_height) {
+        if (x1 >= 0 && x1 < frame_width && y1 >= 0 && y1 < frame_height &&
+            (depth == NULL || renderer_test_line_depth(depth, x1, y1, z)) &&
+            (coverage == NULL || span_buffer_insert_pixel(coverage, y1, x1))) {
             int columnIndex = x1 % 8;
             int byteIndex = calculate_byte_index(y1, x1);
             if (color == kColorWhite)
@@ -418,6 +1055,7 @@ void renderer_draw_line(uint8_t* frame, int x1, int y1, int x2, int y2, int fram
             err += dx;
             y1 += sy;
         }
+        z += stepZ;
     }
 }
 
@@ -430,8 +1068,8 @@ void renderer_draw_line(uint8_t* frame, int x1, int y1, int x2, int y2, int fram
  * @param frame_height The height of the raster frame
  *
  * This function draws a line on a given raster frame by converting the 3D vectors
- * (v1 and v2) to 2D coordinate points, rounding them to integers, and passing them
- * to the renderer_draw_line function.
+ * (v1 and v2) to 2D coordinate points, clipping them to the frame, rounding them to
+ * integers, and passing them to the renderer_draw_line function.
  */
 
 void renderer_draw_line_by_vectors(
@@ -440,13 +1078,48 @@ void renderer_draw_line_by_vectors(
         int frame_width, int frame_height,
         int color
 ) {
-    renderer_draw_line(
+    renderer_draw_segment(data, v1, v2, frame_width, frame_height, color, NULL);
+}
+
+/**
+ * @brief Draws a line between two screen-space vectors, only on pixels not hidden by the occlusion buffers.
+ *
+ * @param occlusion The buffers hiding pixels, NULL to draw every pixel.
+ */
+
+void renderer_draw_segment(
+        uint8_t* data,
+        Vector3 v1, Vector3 v2,
+        int frame_width, int frame_height,
+        int color,
+        const Occlusion* occlusion
+) {
+    Vector3 start = v1, end = v2;
+
+    if (!clip_segment(&v1.x, &v1.y, &v2.x, &v2.y, (float) (frame_width - 1), (float) (frame_height - 1)))
+        return;
+
+    // Depth is linear in screen space, move it along with the clipped end points
+    if (occlusion != NULL && occlusion->depth != NULL) {
+        int alongX = fabsf(end.x - start.x) > fabsf(end.y - start.y);
+        float length = alongX ? end.x - start.x : end.y - start.y;
+
+        if (length != 0.0f) {
+            float t1 = ((alongX ? v1.x - start.x : v1.y - start.y)) / length;
+            float t2 = ((alongX ? v2.x - start.x : v2.y - start.y)) / length;
+            v1.z = start.z + (end.z - start.z) * t1;
+            v2.z = start.z + (end.z - start.z) * t2;
+        }
+    }
+
+    renderer_draw_line_occluded(
             data,
-            (int) roundf(v1.x), (int) roundf(v1.y),
-            (int) roundf(v2.x), (int) roundf(v2.y),
+            (int) roundf(v1.x), (int) roundf(v1.y), v1.z,
+            (int) roundf(v2.x), (int) roundf(v2.y), v2.z,
             frame_width,
             frame_height,
-            color
+            color,
+            occlusion
     );
 }
 
@@ -503,10 +1176,14 @@ int calculate_byte_index(int rowIndex, int columnIndex) {
  * @param triangle The triangle to be rendered.
  */
 
-void renderer_draw_line_by_triangle(uint8_t* data, Triangle triangle, int frame_width, int frame_height, int color) {
-    renderer_draw_line_by_vectors(data, triangle.points[0], triangle.points[1], frame_width, frame_height, color);
-    renderer_draw_line_by_vectors(data, triangle.points[1], triangle.points[2], frame_width, frame_height, color);
-    renderer_draw_line_by_vectors(data, triangle.points[2], triangle.points[0], frame_width, frame_height, color);
+void renderer_draw_line_by_triangle(
+        uint8_t* data,
+        Triangle triangle, int frame_width, int frame_height,
+        int color, const Occlusion* occlusion
+) {
+    renderer_draw_segment(data, triangle.points[0], triangle.points[1], frame_width, frame_height, color, occlusion);
+    renderer_draw_segment(data, triangle.points[1], triangle.points[2], frame_width, frame_height, color, occlusion);
+    renderer_draw_segment(data, triangle.points[2], triangle.points[0], frame_width, frame_height, color, occlusion);
 }
 
 /**
@@ -560,6 +1237,8 @@ void renderer_draw_normal(Renderer* renderer, uint8_t* data, Triangle triangle,
 /**
  * Transforms a 3D vector to 2D space based on the provided renderer.
  *
+ * The depth is mapped to 0 at the near and 1 at the far plane.
+ *
  * @param renderer The Renderer object used for the transformation.
  * @param vector The 3D vector to be transformed.
  * @return The transformed 3D vector in 2D space.
@@ -572,10 +1251,152 @@ Vector3 renderer_transform_to_2d_space(Renderer* renderer, Vector3* vector) {
     vector->x *= 0.5f * (float) renderer->columns;
     vector->y *= 0.5f * (float) renderer->rows;
 
+    vector->z = (vector->z + renderer->depthOffset) * renderer->depthScale;
+
     return *vector;
 }
 
-void renderer_cleanup(Renderer* renderer) {
-    // Cleanup resources and memory used by the renderer
-    // ...
+/**
+ * @brief Performs the perspective divide of a clip-space vertex and maps it to the frame.
+ *
+ * @param renderer The Renderer object used for the transformation.
+ * @param vertex The clip-space vertex, must lie in front of the near plane.
+ * @return The vertex in frame coordinates, z keeps the normalized depth.
+ */
+
+Vector3 renderer_project_clip_vertex(Renderer* renderer, const Vector4* vertex) {
+    float inverseW = 1.0f / vertex->w;
+
+    Vector3 projected = {
+            .x = vertex->x * inverseW,
+            .y = vertex->y * inverseW,
+            .z = vertex->z * inverseW
+    };
+
+    return renderer_transform_to_2d_space(renderer, &projected);
+}
+
+/**
+ * @brief Clips a triangle against the near plane and the guard band and draws what is left.
+ *
+ * The clipped polygon is drawn as a triangle fan. Its outline follows the polygon boundary, so the
+ * fan diagonals never show up as lines.
+ *
+ * @param renderer Pointer to the Renderer struct.
+ * @param data Pointer to the frame buffer.
+ * @param clipVertices The clip-space vertices of the triangle.
+ * @param planes Bit set of the ClipPlane values to clip against.
+ * @param pattern The dither pattern of the triangle brightness.
+ * @param color The color of the outline, kColorClear draws none.
+ * @param occlusion The buffers of the fill engine, all NULL when drawing back to front.
+ */
+
+void renderer_draw_clipped_triangle(
+        Renderer* renderer,
+        uint8_t* data,
+        const Vector4 clipVertices[3],
+        int planes,
+        const DitherPattern* pattern,
+        int color,
+        const Occlusion* occlusion
+) {
+    Vector4 polygon[CLIP_MAX_VERTICES];
+    Vector3 projected[CLIP_MAX_VERTICES];
+
+    int count = clip_polygon(&renderer->clipVolume, planes, clipVertices, 3, polygon);
+    if (count < 3)
+        return;
+
+    for (int i = 0; i < count; i++)
+        projected[i] = renderer_project_clip_vertex(renderer, &polygon[i]);
+
+    renderer_mark_dirty(renderer, projected, count);
+
+    // Front to back the outline has to claim its pixels before the fill, otherwise the fill would hide it
+    if (occlusion->coverage != NULL) {
+        PROFILE_BEGIN(&renderer->profiler, PROFILE_STAGE_LINE);
+        for (int i = 0; i < count; i++)
+            renderer_draw_segment(data, projected[i], projected[(i + 1) % count], renderer->columns, renderer->rows, color, occlusion);
+        PROFILE_END(&renderer->profiler, PROFILE_STAGE_LINE);
+    }
+
+    for (int i = 1; i + 1 < count; i++) {
+        Triangle triangle = {.points = {projected[0], projected[i], projected[i + 1]}};
+
+        PROFILE_BEGIN(&renderer->profiler, PROFILE_STAGE_FILL);
+        renderer_draw_triangle(renderer, data, triangle, pattern, occlusion);
+        PROFILE_END(&renderer->profiler, PROFILE_STAGE_FILL);
+    }
+
+    if (occlusion->coverage == NULL && color != kColorClear) {
+        PROFILE_BEGIN(&renderer->profiler, PROFILE_STAGE_LINE);
+        for (int i = 0; i < count; i++)
+            renderer_draw_segment(data, projected[i], projected[(i + 1) % count], renderer->columns, renderer->rows, color, occlusion);
+        PROFILE_END(&renderer->profiler, PROFILE_STAGE_LINE);
+    }
+}
+
+/**
+ * @brief Adds the pixel bounds of a screen-space polygon to the dirty region of the current frame.
+ *
+ * The bounds are widened by a pixel on every side, so they also cover the rounded outline.
+ *
+ * @param renderer Pointer to the Renderer struct.
+ * @param points The screen-space polygon vertices.
+ * @param count Number of vertices.
+ */
+
+void renderer_mark_dirty(Renderer* renderer, const Vector3* points, int count) {
+    float xMin = points[0].x, xMax = points[0].x;
+    float yMin = points[0].y, yMax = points[0].y;
+
+    for (int i = 1; i < count; i++) {
+        xMin = fminf(xMin, points[i].x);
+        xMax = fmaxf(xMax, points[i].x);
+        yMin = fminf(yMin, points[i].y);
+        yMax = fmaxf(yMax, points[i].y);
+    }
+
+    // Outside of the frame, also keeps the float to int conversion in range
+    if (xMax < 0.0f || yMax < 0.0f || xMin > (float) renderer->columns || yMin > (float) renderer->rows)
+        return;
+
+    dirty_region_add_rect(
+            &renderer->currentDirty,
+            (int) fmaxf(xMin, -1.0f) - 1,
+            (int) fmaxf(yMin, -1.0f) - 1,
+            (int) fminf(xMax, (float) renderer->columns) + 1,
+            (int) fminf(yMax, (float) renderer->rows) + 1
+    );
+}
+
+/**
+ * @brief Frees the renderer, all of its buffers and the font, the renderer can't be used afterwards.
+ *
+ * @param renderer Pointer to the Renderer struct.
+ * @param api Pointer to the PlaydateAPI object the font was loaded with.
+ */
+
+void renderer_cleanup(Renderer* renderer, PlaydateAPI* api) {
+    // Also frees the per-frame buffers and the depth sort, they live in the arena
+    arena_destroy(&renderer->frameArena);
+
+    span_buffer_destroy(&renderer->coverage);
+    depth_buffer_destroy(&renderer->depth);
+
+#ifdef RENDERER_PROFILE
+    profiler_destroy(&renderer->profiler);
+#endif
+
+    dither_destroy(renderer->dither);
+    dirty_region_destroy(&renderer->previousDirty);
+    dirty_region_destroy(&renderer->currentDirty);
+
+    // The SDK has no call to free a font, fonts are released through its allocator
+    if (font != NULL) {
+        api->system->realloc(font, 0);
+        font = NULL;
+    }
+
+    memory_free(renderer);
 }
\ No newline at end of file
@@ -0,0 +1,77 @@
+# Renderer sources, shared by the game, the headless host build and the benchmarks
+set(RENDERER_DIR ${CMAKE_CURRENT_LIST_DIR})
+set(HOST_DIR ${CMAKE_CURRENT_LIST_DIR}/../../host)
+
+set(RENDERER_SOURCES
+        ${RENDERER_DIR}/renderer.h
+        ${RENDERER_DIR}/renderer.c
+        ${RENDERER_DIR}/bayer2.h
+        ${RENDERER_DIR}/bayer8.h
+        ${RENDERER_DIR}/bayer.c
+        ${RENDERER_DIR}/bayer.h
+        ${RENDERER_DIR}/bayer4.h
+        ${RENDERER_DIR}/vector3.h
+        ${RENDERER_DIR}/triangle.h
+        ${RENDERER_DIR}/mesh.h
+        ${RENDERER_DIR}/matrix4x4.h
+        ${RENDERER_DIR}/matrix4x4.c
+        ${RENDERER_DIR}/matrix4x3.h
+        ${RENDERER_DIR}/matrix4x3.c
+        ${RENDERER_DIR}/vector3.c
+        ${RENDERER_DIR}/triangle.c
+        ${RENDERER_DIR}/rasterizer.h
+        ${RENDERER_DIR}/rasterizer.c
+        ${RENDERER_DIR}/scanline.h
+        ${RENDERER_DIR}/scanline.c
+        ${RENDERER_DIR}/dither.h
+        ${RENDERER_DIR}/dither.c
+        ${RENDERER_DIR}/transform.h
+        ${RENDERER_DIR}/transform.c
+        ${RENDERER_DIR}/vector4.h
+        ${RENDERER_DIR}/clip.h
+        ${RENDERER_DIR}/clip.c
+        ${RENDERER_DIR}/dirty_region.h
+        ${RENDERER_DIR}/dirty_region.c
+        ${RENDERER_DIR}/mesh.c
+        ${RENDERER_DIR}/bounds.h
+        ${RENDERER_DIR}/bounds.c
+        ${RENDERER_DIR}/frustum.h
+        ${RENDERER_DIR}/frustum.c
+        ${RENDERER_DIR}/scene.h
+        ${RENDERER_DIR}/scene.c
+        ${RENDERER_DIR}/depth_sort.h
+        ${RENDERER_DIR}/depth_sort.c
+        ${RENDERER_DIR}/span_buffer.h
+        ${RENDERER_DIR}/span_buffer.c
+        ${RENDERER_DIR}/depth_buffer.h
+        ${RENDERER_DIR}/depth_buffer.c
+        ${RENDERER_DIR}/frame_cache.h
+        ${RENDERER_DIR}/frame_cache.c
+        ${RENDERER_DIR}/profiler.h
+        ${RENDERER_DIR}/profiler.c
+        ${RENDERER_DIR}/quality.h
+        ${RENDERER_DIR}/quality.c
+        ${RENDERER_DIR}/mesh_file.h
+        ${RENDERER_DIR}/mesh_file.c
+        ${RENDERER_DIR}/world_stream.h
+        ${RENDERER_DIR}/world_stream.c
+        ${RENDERER_DIR}/scheduler.h
+        ${RENDERER_DIR}/scheduler.c
+        ${RENDERER_DIR}/memory.h
+        ${RENDERER_DIR}/memory.c
+        ${RENDERER_DIR}/arena.h
+        ${RENDERER_DIR}/arena.c
+        ${RENDERER_DIR}/pool.h
+        ${RENDERER_DIR}/pool.c)
+
+# Static renderer library against the stub pd_api.h of host/, built once for the headless game and the benchmarks
+function(add_renderer_host_library)
+    if (TARGET renderer)
+        return()
+    endif ()
+
+    add_library(renderer STATIC ${RENDERER_SOURCES} ${HOST_DIR}/pd_api.h)
+    target_include_directories(renderer PUBLIC ${RENDERER_DIR} ${HOST_DIR})
+    target_compile_definitions(renderer PUBLIC TARGET_HOST)
+    target_link_libraries(renderer PUBLIC m)
+endfunction()
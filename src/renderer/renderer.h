@@ -6,7 +6,35 @@
 #define RENDERER_H
 
 #include "pd_api.h"
+#include "arena.h"
 #include "matrix4x4.h"
+#include "matrix4x3.h"
+#include "triangle.h"
+#include "dither.h"
+#include "clip.h"
+#include "dirty_region.h"
+#include "depth_sort.h"
+#include "span_buffer.h"
+#include "depth_buffer.h"
+#include "frame_cache.h"
+#include "profiler.h"
+#include "quality.h"
+#include "frustum.h"
+#include "scene.h"
+
+typedef enum {
+    FILL_ENGINE_HALF_SPACE,
+    FILL_ENGINE_SCANLINE,
+    FILL_ENGINE_SPAN_BUFFER,    // Scanline fills drawn front to back, every pixel written at most once
+    FILL_ENGINE_DEPTH_BUFFER,   // Half-space fills tested per pixel against a depth buffer, for intersecting geometry
+} FillEngine;
+
+typedef struct {
+    int vertices[3];    // Indices into the vertex cache of the frame
+    float brightness;
+    float fade;         // Share of the pixels written while two levels of detail cross-fade, 1 writes all
+    int fadeInvert;     // Writes the pixels the other level leaves out
+} DrawTriangle;
 
 typedef struct {
     int refreshRate;
@@ -18,15 +46,115 @@ typedef struct {
 
     Vector3 directionalLight;
     Vector3 cameraPosition;
+    float nearPlane;
+    float farPlane;
+    Matrix4x3 viewMatrix;
     Matrix4x4 projectionMatrix;
+    ClipVolume clipVolume;
+    Frustum frustum;
+
+    // Maps the projected z / w at the near and far plane to 0 and 1, for the depth buffer
+    float depthOffset;
+    float depthScale;
+
+    FillEngine fillEngine;
+    int wireframe;      // Only outlines are drawn, no fills
+
+    // Width of the band above a level of detail switch in which both levels are cross-faded, as a share of the
+    // switch radius. 0 switches at once.
+    float lodFade;
+    float lodBias;      // Scales the projected radius before choosing a level of detail, 1 keeps the error under a pixel
+    int bayerSize;
+    DitherTable* dither;
+
+    // Frame areas drawn by the previous and the current frame
+    DirtyRegion previousDirty;
+    DirtyRegion currentDirty;
+
+    // Transient data of the pipeline, sized for the visible geometry and reset at the start of every frame
+    Arena frameArena;
+
+    // Per-frame cache of the transformed vertices of all drawn meshes
+    int frameVertexCount;
+    Vector4* clipVertices;
+    Vector3* screenVertices;
+    uint16_t* outcodes;
+    uint8_t* vertexUsed;
+
+    // Per-frame list of the front facing triangles of the mesh being drawn
+    int* visibleFaces;
+
+    // Per-frame indices and coordinates of the vertices used by the front faces of the mesh being drawn
+    int* usedVertices;
+    float* usedX;
+    float* usedY;
+    float* usedZ;
+
+    // Per-frame list of the triangles to draw, sorted back to front by their depth keys
+    int drawCount;
+    DrawTriangle* drawTriangles;
+    DepthSort depthSort;
+
+    // Pixels drawn so far this frame, only used by FILL_ENGINE_SPAN_BUFFER
+    SpanBuffer coverage;
+
+    // Nearest depth drawn so far this frame, only used by FILL_ENGINE_DEPTH_BUFFER
+    DepthBuffer depth;
+
+#ifdef RENDERER_PROFILE
+    Profiler profiler;
+#endif
 } Renderer;
 
 Renderer* renderer_create(PlaydateAPI* api, int refreshRate, int scale);
 
 void renderer_init(Renderer* renderer, PlaydateAPI* api);
 
-void renderer_draw(Renderer* renderer, PlaydateAPI* api);
+int renderer_draw(Renderer* renderer, PlaydateAPI* api, Scene* scene);
+
+int renderer_draw_cached(Renderer* renderer, PlaydateAPI* api, Scene* scene, FrameCache* cache, int key);
+
+void renderer_set_scale(Renderer* renderer, PlaydateAPI* api, int scale);
+
+void renderer_set_dither(Renderer* renderer, int bayerSize);
+
+void renderer_set_quality(Renderer* renderer, PlaydateAPI* api, const QualityLevel* quality);
+
+#ifdef RENDERER_PROFILE
+void renderer_draw_profiler(Renderer* renderer);
+#endif
+
+void renderer_cleanup(Renderer* renderer, PlaydateAPI* api);
+
+// Raster primitives drawing into a frame buffer with LCD_ROWSIZE bytes per row
+
+void renderer_draw_fill(
+        uint8_t* frame,
+        int x1, int y1,
+        int x2, int y2,
+        int x3, int y3,
+        int frame_width, int frame_height,
+        const DitherPattern* pattern
+);
+
+void renderer_draw_fill_depth(
+        uint8_t* frame,
+        int x1, int y1, float z1,
+        int x2, int y2, float z2,
+        int x3, int y3, float z3,
+        int frame_width, int frame_height,
+        const DitherPattern* pattern,
+        DepthBuffer* depth
+);
+
+void renderer_draw_fill_by_triangle(
+        uint8_t* data,
+        Triangle triangle, int frame_width, int frame_height,
+        const DitherPattern* pattern, FillEngine engine
+);
+
+void renderer_draw_line(uint8_t* frame, int x1, int y1, int x2, int y2, int frame_width, int frame_height, int color);
 
-void renderer_cleanup(Renderer* renderer);
+void renderer_draw_line_by_vectors(uint8_t* data, Vector3 v1, Vector3 v2, int frame_width, int frame_height, int color);
 
 #endif /* RENDERER_H */
\ No newline at end of file
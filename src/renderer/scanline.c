@@ -0,0 +1,296 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#include <math.h>
+#include <string.h>
+#include "scanline.h"
+#include "rasterizer.h"
+#include "pd_api.h"
+
+typedef struct {
+    int x;          // Integer part of the edge x-coordinate at the current row
+    int remainder;  // Fractional part of the edge x-coordinate, scaled by denominator
+    int stepX;      // Integer part of the x change per row
+    int stepRemainder;  // Fractional part of the x change per row, scaled by denominator
+    int denominator;
+} EdgeWalker;
+
+/**
+ * @brief Divides two 64-bit integers, rounding towards negative infinity.
+ *
+ * @param numerator The dividend.
+ * @param denominator The divisor, must be positive.
+ * @return The quotient rounded down.
+ */
+
+static int64_t floor_divide(int64_t numerator, int64_t denominator) {
+    int64_t quotient = numerator / denominator;
+    if ((numerator % denominator) != 0 && numerator < 0)
+        quotient--;
+    return quotient;
+}
+
+/**
+ * @brief Sets up an exact DDA walking the edge (x0, y0) -> (x1, y1) one pixel row at a time.
+ *
+ * All coordinates are in 28.4 fixed point and y1 must be greater than y0. The edge x-coordinate is kept
+ * as a quotient and remainder, so stepping never accumulates rounding errors no matter how long the edge is.
+ *
+ * @param edge The walker to initialize.
+ * @param x0 X-coordinate of the upper vertex.
+ * @param y0 Y-coordinate of the upper vertex.
+ * @param x1 X-coordinate of the lower vertex.
+ * @param y1 Y-coordinate of the lower vertex.
+ * @param row The first pixel row the edge is sampled at.
+ */
+
+static void edge_walker_init(EdgeWalker* edge, int x0, int y0, int x1, int y1, int row) {
+    int64_t dx = x1 - x0;
+    int64_t dy = y1 - y0;
+    int64_t denominator = dy * SCANLINE_SUBPIXEL_ONE;
+    int64_t numerator = (int64_t) x0 * dy + dx * ((int64_t) row * SCANLINE_SUBPIXEL_ONE - y0);
+    int64_t step = dx * SCANLINE_SUBPIXEL_ONE;
+
+    int64_t x = floor_divide(numerator, denominator);
+    int64_t stepX = floor_divide(step, denominator);
+
+    edge->x = (int) x;
+    edge->remainder = (int) (numerator - x * denominator);
+    edge->stepX = (int) stepX;
+    edge->stepRemainder = (int) (step - stepX * denominator);
+    edge->denominator = (int) denominator;
+}
+
+/**
+ * @brief Returns the first pixel column at or right of the edge on the current row.
+ */
+
+static inline int edge_walker_column(const EdgeWalker* edge) {
+    return edge->x + (edge->remainder > 0);
+}
+
+static inline void edge_walker_step(EdgeWalker* edge) {
+    edge->x += edge->stepX;
+    edge->remainder += edge->stepRemainder;
+    if (edge->remainder >= edge->denominator) {
+        edge->x++;
+        edge->remainder -= edge->denominator;
+    }
+}
+
+/**
+ * @brief Fills the pixels [x0, x1) of a single frame row with the row's dither pattern.
+ *
+ * The leading and trailing partial bytes are merged with a mask, all bytes in between are copied whole.
+ * Patterns that repeat within a byte are set with a single memset.
+ *
+ * @param row Pointer to the first byte of the row.
+ * @param x0 First pixel of the span.
+ * @param x1 Pixel after the last pixel of the span.
+ * @param patternRow The dither pattern bytes of the row.
+ * @param byteMask Mask turning a frame byte column into a pattern byte column.
+ */
+
+void scanline_fill_span(uint8_t* row, int x0, int x1, const uint8_t* patternRow, int byteMask) {
+    int first = x0 >> 3;
+    int last = (x1 - 1) >> 3;
+
+    uint8_t leftMask = 0xFF >> (x0 & 7);
+    uint8_t rightMask = (uint8_t) (0xFF << (7 - ((x1 - 1) & 7)));
+    uint8_t pattern = patternRow[first & byteMask];
+
+    if (first == last) {
+        uint8_t mask = leftMask & rightMask;
+        row[first] = (row[first] & ~mask) | (pattern & mask);
+        return;
+    }
+
+    row[first] = (row[first] & ~leftMask) | (pattern & leftMask);
+
+    if (byteMask == 0) {
+        memset(row + first + 1, pattern, last - first - 1);
+    } else {
+        for (int byte = first + 1; byte < last; byte++)
+            row[byte] = patternRow[byte & byteMask];
+    }
+
+    pattern = patternRow[last & byteMask];
+    row[last] = (row[last] & ~rightMask) | (pattern & rightMask);
+}
+
+/**
+ * @brief Fills a span like scanline_fill_span, but only the pixels the screen door of the pattern lets through.
+ *
+ * @param row Pointer to the first byte of the row.
+ * @param x0 First pixel of the span.
+ * @param x1 Pixel after the last pixel of the span.
+ * @param patternRow The dither pattern bytes of the row.
+ * @param doorRow The door bytes of the row.
+ * @param byteMask Mask turning a frame byte column into a pattern byte column.
+ * @param doorFlip Inverts the door.
+ */
+
+static void scanline_fill_span_door(
+        uint8_t* row,
+        int x0, int x1,
+        const uint8_t* patternRow,
+        const uint8_t* doorRow,
+        int byteMask,
+        uint8_t doorFlip
+) {
+    int first = x0 >> 3;
+    int last = (x1 - 1) >> 3;
+
+    for (int byte = first; byte <= last; byte++) {
+        uint8_t mask = doorRow[byte & byteMask] ^ doorFlip;
+        if (byte == first)
+            mask &= 0xFF >> (x0 & 7);
+        if (byte == last)
+            mask &= (uint8_t) (0xFF << (7 - ((x1 - 1) & 7)));
+
+        row[byte] = (row[byte] & ~mask) | (patternRow[byte & byteMask] & mask);
+    }
+}
+
+/**
+ * @brief Converts a pixel coordinate to 28.4 fixed point.
+ *
+ * @param value The coordinate in pixels.
+ * @param out The fixed-point coordinate.
+ * @return 1 if the coordinate lies within the guard band, 0 otherwise.
+ */
+
+static int to_fixed(float value, int* out) {
+    if (!(fabsf(value) <= (float) RASTERIZER_GUARD_BAND))
+        return 0;
+
+    *out = (int) lroundf(value * SCANLINE_SUBPIXEL_ONE);
+    return 1;
+}
+
+/**
+ * @brief Fills a triangle into a 1-bit frame buffer by walking its edges and emitting horizontal spans.
+ *
+ * The vertices are snapped to a 1/16 pixel grid instead of whole pixels, so slowly moving vertices move the
+ * covered pixels smoothly. Pixels are sampled at their integer coordinates and a strict top-left rule decides
+ * ownership: a row is covered from the top vertex up to but excluding the bottom vertex and a span from the
+ * left edge up to but excluding the right edge. Triangles sharing an edge therefore never touch the same pixel
+ * and never leave a gap between them.
+ *
+ * @param frame Pointer to the frame buffer.
+ * @param triangle The screen space triangle, coordinates in pixels.
+ * @param frame_width Width of the frame buffer.
+ * @param frame_height Height of the frame buffer.
+ * @param pattern The dither pattern of the triangle brightness.
+ */
+
+void scanline_fill_triangle(
+        uint8_t* frame,
+        const Triangle* triangle,
+        int frame_width, int frame_height,
+        const DitherPattern* pattern
+) {
+    scanline_fill_triangle_covered(frame, triangle, frame_width, frame_height, pattern, NULL);
+}
+
+/**
+ * @brief Fills a triangle like scanline_fill_triangle, but only the pixels not yet covered in the span buffer.
+ *
+ * Every span is clipped against the covered intervals of its row before it is written and then added to
+ * them, so triangles drawn front to back never overdraw each other.
+ *
+ * @param frame Pointer to the frame buffer.
+ * @param triangle The screen space triangle, coordinates in pixels.
+ * @param frame_width Width of the frame buffer, at most the width of the span buffer.
+ * @param frame_height Height of the frame buffer, at most the rows of the span buffer.
+ * @param pattern The dither pattern of the triangle brightness.
+ * @param coverage The pixels already drawn this frame, NULL to draw every pixel.
+ */
+
+void scanline_fill_triangle_covered(
+        uint8_t* frame,
+        const Triangle* triangle,
+        int frame_width, int frame_height,
+        const DitherPattern* pattern,
+        SpanBuffer* coverage
+) {
+    int x[3], y[3];
+
+    for (int p = 0; p < 3; p++) {
+        if (!to_fixed(triangle->points[p].x, &x[p]) || !to_fixed(triangle->points[p].y, &y[p]))
+            return;
+    }
+
+    // Sort vertices from top to bottom
+    int top = 0, middle = 1, bottom = 2, swap;
+    if (y[top] > y[middle]) swap = top, top = middle, middle = swap;
+    if (y[middle] > y[bottom]) swap = middle, middle = bottom, bottom = swap;
+    if (y[top] > y[middle]) swap = top, top = middle, middle = swap;
+
+    if (y[top] == y[bottom])
+        return;
+
+    // Sign of the cross product tells on which side of the long edge the middle vertex lies
+    int64_t cross = (int64_t) (x[bottom] - x[top]) * (y[middle] - y[top]) -
+                    (int64_t) (y[bottom] - y[top]) * (x[middle] - x[top]);
+    if (cross == 0)
+        return;
+
+    int middleOnLeft = cross > 0;
+
+    // First row whose sample point lies at or below each vertex
+    int rowTop = (int) floor_divide((int64_t) y[top] + SCANLINE_SUBPIXEL_ONE - 1, SCANLINE_SUBPIXEL_ONE);
+    int rowMiddle = (int) floor_divide((int64_t) y[middle] + SCANLINE_SUBPIXEL_ONE - 1, SCANLINE_SUBPIXEL_ONE);
+    int rowBottom = (int) floor_divide((int64_t) y[bottom] + SCANLINE_SUBPIXEL_ONE - 1, SCANLINE_SUBPIXEL_ONE);
+
+    int rowStart = rowTop > 0 ? rowTop : 0;
+    int rowEnd = rowBottom < frame_height ? rowBottom : frame_height;
+
+    if (rowStart >= rowEnd)
+        return;
+
+    EdgeWalker longEdge, shortEdge;
+    edge_walker_init(&longEdge, x[top], y[top], x[bottom], y[bottom], rowStart);
+
+    int upperHalf = rowStart < rowMiddle;
+    if (upperHalf)
+        edge_walker_init(&shortEdge, x[top], y[top], x[middle], y[middle], rowStart);
+    else
+        edge_walker_init(&shortEdge, x[middle], y[middle], x[bottom], y[bottom], rowStart);
+
+    uint8_t* row = frame + rowStart * LCD_ROWSIZE;
+
+    for (int rowIndex = rowStart; rowIndex < rowEnd; rowIndex++, row += LCD_ROWSIZE) {
+        if (upperHalf && rowIndex == rowMiddle) {
+            upperHalf = 0;
+            edge_walker_init(&shortEdge, x[middle], y[middle], x[bottom], y[bottom], rowIndex);
+        }
+
+        int x0 = edge_walker_column(middleOnLeft ? &shortEdge : &longEdge);
+        int x1 = edge_walker_column(middleOnLeft ? &longEdge : &shortEdge);
+
+        if (x0 < 0) x0 = 0;
+        if (x1 > frame_width) x1 = frame_width;
+
+        if (x0 < x1) {
+            const uint8_t* patternRow = dither_pattern_row(pattern, rowIndex);
+
+            if (pattern->door != NULL) {
+                // Cross-fades are only drawn back to front, without coverage
+                const uint8_t* doorRow = dither_door_row(pattern, rowIndex);
+                scanline_fill_span_door(row, x0, x1, patternRow, doorRow, pattern->byteMask, pattern->doorFlip);
+            } else if (coverage == NULL) {
+                scanline_fill_span(row, x0, x1, patternRow, pattern->byteMask);
+            } else {
+                int visibleCount = span_buffer_insert(coverage, rowIndex, x0, x1);
+
+                for (int v = 0; v < visibleCount; v++)
+                    scanline_fill_span(row, coverage->visible[v].start, coverage->visible[v].end, patternRow, pattern->byteMask);
+            }
+        }
+
+        edge_walker_step(&longEdge);
+        edge_walker_step(&shortEdge);
+    }
+}
@@ -0,0 +1,62 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#ifndef INC_3D_SCANLINE_H
+#define INC_3D_SCANLINE_H
+
+#include <stdint.h>
+#include "triangle.h"
+#include "dither.h"
+#include "span_buffer.h"
+
+// Number of fractional bits of the fixed-point vertex coordinates (28.4).
+#define SCANLINE_SUBPIXEL_BITS 4
+#define SCANLINE_SUBPIXEL_ONE (1 << SCANLINE_SUBPIXEL_BITS)
+
+/**
+ * Fills a triangle into a 1-bit frame buffer by walking its edges in 28.4 fixed point and emitting spans.
+ *
+ * @param frame Pointer to the frame buffer (LCD_ROWSIZE bytes per row).
+ * @param triangle The screen space triangle, coordinates in pixels.
+ * @param frame_width Width of the frame buffer in pixels.
+ * @param frame_height Height of the frame buffer in pixels.
+ * @param pattern The dither pattern of the triangle brightness.
+ */
+void scanline_fill_triangle(
+        uint8_t* frame,
+        const Triangle* triangle,
+        int frame_width, int frame_height,
+        const DitherPattern* pattern
+);
+
+/**
+ * Fills the pixels of a triangle that aren't covered in the span buffer yet and marks them as covered.
+ *
+ * @param frame Pointer to the frame buffer (LCD_ROWSIZE bytes per row).
+ * @param triangle The screen space triangle, coordinates in pixels.
+ * @param frame_width Width of the frame buffer in pixels.
+ * @param frame_height Height of the frame buffer in pixels.
+ * @param pattern The dither pattern of the triangle brightness.
+ * @param coverage The pixels already drawn this frame, NULL to draw every pixel.
+ */
+void scanline_fill_triangle_covered(
+        uint8_t* frame,
+        const Triangle* triangle,
+        int frame_width, int frame_height,
+        const DitherPattern* pattern,
+        SpanBuffer* coverage
+);
+
+/**
+ * Fills the pixels [x0, x1) of a single frame row with the row's dither pattern.
+ *
+ * @param row Pointer to the first byte of the row.
+ * @param x0 First pixel of the span.
+ * @param x1 Pixel after the last pixel of the span.
+ * @param patternRow The dither pattern bytes of the row.
+ * @param byteMask Mask turning a frame byte column into a pattern byte column.
+ */
+void scanline_fill_span(uint8_t* row, int x0, int x1, const uint8_t* patternRow, int byteMask);
+
+#endif //INC_3D_SCANLINE_H
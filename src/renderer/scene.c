@@ -0,0 +1,247 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#include <stdlib.h>
+#include "scene.h"
+#include "memory.h"
+
+// Nodes allocated at once whenever the node pool runs out
+#define SCENE_NODES_PER_SLAB 32
+
+static SceneNode* scene_node_create(Scene* scene, const Mesh* mesh) {
+    SceneNode* node = pool_alloc(&scene->nodes);
+    if (node == NULL)
+        return NULL;
+
+    node->mesh = mesh;
+    node->position = (Vector3) {.x = 0.0f, .y = 0.0f, .z = 0.0f};
+    node->rotation = (Vector3) {.x = 0.0f, .y = 0.0f, .z = 0.0f};
+    node->scale = (Vector3) {.x = 1.0f, .y = 1.0f, .z = 1.0f};
+    node->parent = NULL;
+    node->firstChild = NULL;
+    node->nextSibling = NULL;
+    node->worldMatrix = matrix4x3_identity();
+    node->worldBounds = bounding_sphere_empty();
+    node->subtreeBounds = bounding_sphere_empty();
+    node->dirty = 1;
+    node->childDirty = 0;
+
+    return node;
+}
+
+/**
+ * @brief Frees a node and all of its descendants.
+ *
+ * @return Number of freed nodes.
+ */
+
+static int scene_node_destroy(Scene* scene, SceneNode* node) {
+    int count = 1;
+
+    SceneNode* child = node->firstChild;
+    while (child != NULL) {
+        SceneNode* next = child->nextSibling;
+        count += scene_node_destroy(scene, child);
+        child = next;
+    }
+
+    pool_free(&scene->nodes, node);
+    return count;
+}
+
+/**
+ * @brief Flags the ancestors of a node, so scene_update walks down to it.
+ *
+ * Stops at the first ancestor that is already flagged, everything above it is flagged as well.
+ */
+
+static void scene_node_mark_ancestors(SceneNode* node) {
+    for (SceneNode* parent = node->parent; parent != NULL && !parent->childDirty; parent = parent->parent)
+        parent->childDirty = 1;
+}
+
+static void scene_node_mark_dirty(SceneNode* node) {
+    node->dirty = 1;
+    scene_node_mark_ancestors(node);
+}
+
+/**
+ * @brief Creates an empty scene with a group node as its root.
+ *
+ * @return A pointer to the new scene.
+ */
+
+Scene* scene_create(void) {
+    Scene* scene = memory_alloc(sizeof(Scene));
+    pool_init(&scene->nodes, sizeof(SceneNode), SCENE_NODES_PER_SLAB);
+    scene->root = scene_node_create(scene, NULL);
+    scene->nodeCount = 1;
+    return scene;
+}
+
+/**
+ * @brief Frees the scene and all of its nodes. The meshes are owned by the caller and not freed.
+ */
+
+void scene_destroy(Scene* scene) {
+    if (scene == NULL)
+        return;
+
+    pool_destroy(&scene->nodes);
+    memory_free(scene);
+}
+
+/**
+ * @brief Adds a new node to the scene.
+ *
+ * @param scene The scene.
+ * @param parent The parent node, NULL to add the node to the root.
+ * @param mesh The mesh drawn at the node, NULL for a group node. Must outlive the node.
+ * @return The new node with an identity transform, NULL if out of memory.
+ */
+
+SceneNode* scene_add(Scene* scene, SceneNode* parent, const Mesh* mesh) {
+    if (parent == NULL)
+        parent = scene->root;
+
+    SceneNode* node = scene_node_create(scene, mesh);
+    if (node == NULL)
+        return NULL;
+
+    node->parent = parent;
+    node->nextSibling = parent->firstChild;
+    parent->firstChild = node;
+
+    scene->nodeCount++;
+    scene_node_mark_dirty(node);
+
+    return node;
+}
+
+/**
+ * @brief Removes a node and all of its descendants from the scene and frees them.
+ *
+ * @param scene The scene.
+ * @param node The node to remove, the root can't be removed.
+ */
+
+void scene_remove(Scene* scene, SceneNode* node) {
+    if (node == NULL || node == scene->root)
+        return;
+
+    SceneNode** link = &node->parent->firstChild;
+    while (*link != node)
+        link = &(*link)->nextSibling;
+    *link = node->nextSibling;
+
+    // The bounds of all ancestors have to shrink
+    node->parent->childDirty = 1;
+    scene_node_mark_ancestors(node->parent);
+
+    scene->nodeCount -= scene_node_destroy(scene, node);
+}
+
+void scene_node_set_position(SceneNode* node, Vector3 position) {
+    node->position = position;
+    scene_node_mark_dirty(node);
+}
+
+void scene_node_set_rotation(SceneNode* node, Vector3 rotation) {
+    node->rotation = rotation;
+    scene_node_mark_dirty(node);
+}
+
+void scene_node_set_scale(SceneNode* node, Vector3 scale) {
+    node->scale = scale;
+    scene_node_mark_dirty(node);
+}
+
+/**
+ * @brief Recomputes the world matrix and bounds of a node whose transform or parent transform changed.
+ */
+
+static void scene_node_update_world(SceneNode* node) {
+    Matrix4x3 local = matrix4x3_transform(node->position, node->rotation, node->scale);
+
+    if (node->parent != NULL)
+        matrix4x3_multiply(&local, &node->parent->worldMatrix, &node->worldMatrix);
+    else
+        node->worldMatrix = local;
+
+    node->worldBounds = node->mesh != NULL
+                        ? bounding_sphere_transform(node->mesh->bounds, &node->worldMatrix)
+                        : bounding_sphere_empty();
+}
+
+/**
+ * @brief Brings the cached state of a subtree up to date.
+ *
+ * Subtrees without changes are skipped entirely, so the cost follows the number of changed nodes.
+ *
+ * @param node The root of the subtree.
+ * @param parentChanged Whether the world matrix of the parent changed during this update.
+ */
+
+static void scene_node_update(SceneNode* node, int parentChanged) {
+    int changed = parentChanged || node->dirty;
+
+    if (changed)
+        scene_node_update_world(node);
+
+    if (changed || node->childDirty) {
+        BoundingSphere bounds = node->worldBounds;
+
+        for (SceneNode* child = node->firstChild; child != NULL; child = child->nextSibling) {
+            scene_node_update(child, changed);
+            bounds = bounding_sphere_merge(bounds, child->subtreeBounds);
+        }
+
+        node->subtreeBounds = bounds;
+    }
+
+    node->dirty = 0;
+    node->childDirty = 0;
+}
+
+/**
+ * @brief Recomputes the world matrices and bounds of all nodes changed since the last update.
+ */
+
+void scene_update(Scene* scene) {
+    scene_node_update(scene->root, 0);
+}
+
+static int scene_node_visit_visible(const SceneNode* node, const Frustum* frustum, SceneVisitor visitor, void* context) {
+    if (!frustum_contains_sphere(frustum, &node->subtreeBounds))
+        return 0;
+
+    int visited = 0;
+
+    if (node->mesh != NULL && frustum_contains_sphere(frustum, &node->worldBounds)) {
+        visitor(context, node);
+        visited++;
+    }
+
+    for (const SceneNode* child = node->firstChild; child != NULL; child = child->nextSibling)
+        visited += scene_node_visit_visible(child, frustum, visitor, context);
+
+    return visited;
+}
+
+/**
+ * @brief Calls the visitor for every mesh node whose bounds intersect the frustum.
+ *
+ * Subtrees whose combined bounds lie outside the frustum are skipped without looking at their nodes.
+ * The scene must be up to date, see scene_update.
+ *
+ * @param scene The scene.
+ * @param frustum The view frustum in world space.
+ * @param visitor Function called for every visible node.
+ * @param context Passed through to the visitor.
+ * @return Number of visited nodes.
+ */
+
+int scene_visit_visible(const Scene* scene, const Frustum* frustum, SceneVisitor visitor, void* context) {
+    return scene_node_visit_visible(scene->root, frustum, visitor, context);
+}
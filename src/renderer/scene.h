@@ -0,0 +1,65 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#ifndef INC_3D_SCENE_H
+#define INC_3D_SCENE_H
+
+#include "mesh.h"
+#include "frustum.h"
+#include "pool.h"
+
+typedef struct SceneNode SceneNode;
+
+/**
+ * Node of the scene hierarchy. A node places an optional mesh relative to its parent, nodes without a mesh
+ * only group their children.
+ */
+struct SceneNode {
+    const Mesh* mesh;
+
+    // Local transform, rotation in radians applied around X, then Z, then Y
+    Vector3 position;
+    Vector3 rotation;
+    Vector3 scale;
+
+    SceneNode* parent;
+    SceneNode* firstChild;
+    SceneNode* nextSibling;
+
+    // Cached by scene_update, only valid after the update
+    Matrix4x3 worldMatrix;
+    BoundingSphere worldBounds;     // Bounds of the node's own mesh
+    BoundingSphere subtreeBounds;   // Bounds of the node's mesh and all descendants
+
+    int dirty;          // Local transform changed since the last update
+    int childDirty;     // Some descendant changed since the last update
+};
+
+typedef struct {
+    SceneNode* root;
+    int nodeCount;
+    Pool nodes;     // Every node of the scene is allocated from here
+} Scene;
+
+typedef void (*SceneVisitor)(void* context, const SceneNode* node);
+
+Scene* scene_create(void);
+
+void scene_destroy(Scene* scene);
+
+SceneNode* scene_add(Scene* scene, SceneNode* parent, const Mesh* mesh);
+
+void scene_remove(Scene* scene, SceneNode* node);
+
+void scene_node_set_position(SceneNode* node, Vector3 position);
+
+void scene_node_set_rotation(SceneNode* node, Vector3 rotation);
+
+void scene_node_set_scale(SceneNode* node, Vector3 scale);
+
+void scene_update(Scene* scene);
+
+int scene_visit_visible(const Scene* scene, const Frustum* frustum, SceneVisitor visitor, void* context);
+
+#endif //INC_3D_SCENE_H
@@ -0,0 +1,167 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#include "scheduler.h"
+
+// Weight of the latest step in the smoothed cost of a job
+#define SCHEDULER_COST_SMOOTHING 0.25f
+
+// Jobs allocated at once whenever the job pool runs out
+#define SCHEDULER_JOBS_PER_SLAB 16
+
+static Job* scheduler_next(const Scheduler* scheduler);
+
+static void scheduler_unlink(Scheduler* scheduler, Job* job);
+
+static void scheduler_append(Scheduler* scheduler, Job* job);
+
+void scheduler_init(Scheduler* scheduler, PlaydateAPI* api) {
+    scheduler->api = api;
+    scheduler->jobCount = 0;
+    scheduler->frame = 0;
+    pool_init(&scheduler->jobs, sizeof(Job), SCHEDULER_JOBS_PER_SLAB);
+
+    for (int priority = 0; priority < JOB_PRIORITY_COUNT; priority++) {
+        scheduler->first[priority] = NULL;
+        scheduler->last[priority] = NULL;
+    }
+}
+
+/**
+ * @brief Frees every job without finishing it, contexts are left to their owners.
+ */
+
+void scheduler_destroy(Scheduler* scheduler) {
+    for (int priority = 0; priority < JOB_PRIORITY_COUNT; priority++) {
+        while (scheduler->first[priority] != NULL)
+            scheduler_cancel(scheduler, scheduler->first[priority]);
+    }
+
+    pool_destroy(&scheduler->jobs);
+}
+
+/**
+ * @brief Adds a job, its first step is taken in the next run.
+ *
+ * @param scheduler The scheduler.
+ * @param step Called with the job whenever it is its turn.
+ * @param context Passed to the step function as job->context.
+ * @param priority Jobs of a higher priority get the time first.
+ * @return The job, valid until it is done or cancelled. NULL if out of memory, the job is never run then.
+ */
+
+Job* scheduler_add(Scheduler* scheduler, JobStep step, void* context, JobPriority priority) {
+    Job* job = pool_alloc(&scheduler->jobs);
+    if (job == NULL)
+        return NULL;
+
+    job->step = step;
+    job->context = context;
+    job->state = 0;
+    job->priority = priority;
+    job->cost = 0.0f;
+    job->waitFrame = -1;
+
+    scheduler_append(scheduler, job);
+    scheduler->jobCount++;
+
+    return job;
+}
+
+/**
+ * @brief Removes a job and frees it. A job ends itself by returning JOB_DONE instead.
+ */
+
+void scheduler_cancel(Scheduler* scheduler, Job* job) {
+    scheduler_unlink(scheduler, job);
+    scheduler->jobCount--;
+    pool_free(&scheduler->jobs, job);
+}
+
+/**
+ * @brief Steps jobs until the deadline or until no job has anything to do.
+ *
+ * A job whose smoothed step cost doesn't fit into the time left sits out the rest of the frame, jobs with
+ * cheaper steps may still use it.
+ *
+ * @param scheduler The scheduler.
+ * @param deadline Elapsed time in seconds at which the frame has to be done, see getElapsedTime.
+ * @return Number of steps taken.
+ */
+
+int scheduler_run(Scheduler* scheduler, float deadline) {
+    const struct playdate_sys* system = scheduler->api->system;
+    int steps = 0;
+
+    scheduler->frame++;
+
+    Job* job;
+    while ((job = scheduler_next(scheduler)) != NULL) {
+        float start = system->getElapsedTime();
+        if (start >= deadline)
+            break;
+
+        // Forgets part of the cost, so a single slow step doesn't lock the job out for good
+        if (start + job->cost > deadline) {
+            job->cost -= job->cost * SCHEDULER_COST_SMOOTHING;
+            job->waitFrame = scheduler->frame;
+            continue;
+        }
+
+        JobStatus status = job->step(job);
+        float time = system->getElapsedTime() - start;
+        steps++;
+
+        if (status == JOB_DONE) {
+            scheduler_cancel(scheduler, job);
+            continue;
+        }
+
+        job->cost = job->cost > 0.0f ? job->cost + (time - job->cost) * SCHEDULER_COST_SMOOTHING : time;
+        if (status == JOB_WAIT)
+            job->waitFrame = scheduler->frame;
+
+        // Back of the line, so jobs of the same priority take turns
+        scheduler_unlink(scheduler, job);
+        scheduler_append(scheduler, job);
+    }
+
+    return steps;
+}
+
+static Job* scheduler_next(const Scheduler* scheduler) {
+    for (int priority = 0; priority < JOB_PRIORITY_COUNT; priority++) {
+        for (Job* job = scheduler->first[priority]; job != NULL; job = job->next) {
+            if (job->waitFrame != scheduler->frame)
+                return job;
+        }
+    }
+
+    return NULL;
+}
+
+static void scheduler_unlink(Scheduler* scheduler, Job* job) {
+    Job* previous = NULL;
+    for (Job* other = scheduler->first[job->priority]; other != job; other = other->next)
+        previous = other;
+
+    if (previous != NULL)
+        previous->next = job->next;
+    else
+        scheduler->first[job->priority] = job->next;
+
+    if (scheduler->last[job->priority] == job)
+        scheduler->last[job->priority] = previous;
+}
+
+static void scheduler_append(Scheduler* scheduler, Job* job) {
+    job->next = NULL;
+
+    if (scheduler->last[job->priority] != NULL)
+        scheduler->last[job->priority]->next = job;
+    else
+        scheduler->first[job->priority] = job;
+
+    scheduler->last[job->priority] = job;
+}
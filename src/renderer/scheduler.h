@@ -0,0 +1,63 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#ifndef INC_3D_SCHEDULER_H
+#define INC_3D_SCHEDULER_H
+
+#include "pd_api.h"
+#include "pool.h"
+
+typedef enum {
+    JOB_PRIORITY_HIGH,
+    JOB_PRIORITY_NORMAL,
+    JOB_PRIORITY_LOW,
+    JOB_PRIORITY_COUNT
+} JobPriority;
+
+typedef enum {
+    JOB_CONTINUE,   // More work, step again as soon as there is time
+    JOB_WAIT,       // Nothing to do until the next frame
+    JOB_DONE,       // Finished, the job is removed
+} JobStatus;
+
+typedef struct Job Job;
+
+// Does a small piece of work and returns, must not block
+typedef JobStatus (*JobStep)(Job* job);
+
+struct Job {
+    JobStep step;
+    void* context;
+    int state;          // Free for the step function, 0 on the first step. Lets a state machine resume.
+    JobPriority priority;
+    float cost;         // Smoothed seconds per step, 0 before the first step
+    int waitFrame;      // Frame the job sits out
+    Job* next;
+};
+
+/**
+ * Runs jobs cooperatively in the time left of a frame. Jobs of a higher priority go first, jobs of the same
+ * priority take turns step by step. A step is only started if its usual cost fits before the deadline, so the
+ * scheduler doesn't push a frame over its budget.
+ */
+typedef struct {
+    PlaydateAPI* api;
+    Job* first[JOB_PRIORITY_COUNT];
+    Job* last[JOB_PRIORITY_COUNT];
+    int jobCount;
+    int frame;
+    Pool jobs;
+} Scheduler;
+
+void scheduler_init(Scheduler* scheduler, PlaydateAPI* api);
+
+void scheduler_destroy(Scheduler* scheduler);
+
+Job* scheduler_add(Scheduler* scheduler, JobStep step, void* context, JobPriority priority);
+
+void scheduler_cancel(Scheduler* scheduler, Job* job);
+
+int scheduler_run(Scheduler* scheduler, float deadline);
+
+#endif //INC_3D_SCHEDULER_H
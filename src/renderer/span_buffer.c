@@ -0,0 +1,148 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#include <stdlib.h>
+#include <string.h>
+#include "span_buffer.h"
+#include "memory.h"
+
+/**
+ * @brief Initializes an empty span buffer.
+ *
+ * @param buffer The span buffer to initialize.
+ * @param rows Number of rows.
+ * @param width Number of pixels per row.
+ */
+
+void span_buffer_init(SpanBuffer* buffer, int rows, int width) {
+    buffer->rows = rows;
+    buffer->width = width;
+    buffer->fullRows = 0;
+    buffer->rowSpans = memory_calloc(rows, sizeof(SpanRow));
+
+    // Disjoint spans that don't touch leave at least one pixel between them
+    buffer->visible = memory_alloc(sizeof(Span) * (width / 2 + 2));
+
+    // Every row gets room for the most spans it can hold, so inserting never allocates
+    int capacity = (width + 1) / 2;
+    buffer->storage = memory_alloc(sizeof(Span) * capacity * rows);
+
+    for (int row = 0; row < rows; row++) {
+        buffer->rowSpans[row].capacity = capacity;
+        buffer->rowSpans[row].spans = buffer->storage + capacity * row;
+    }
+}
+
+void span_buffer_destroy(SpanBuffer* buffer) {
+    memory_free(buffer->rowSpans);
+    memory_free(buffer->visible);
+    memory_free(buffer->storage);
+    buffer->rowSpans = NULL;
+    buffer->visible = NULL;
+    buffer->storage = NULL;
+}
+
+/**
+ * @brief Marks every pixel as uncovered. The span storage is kept for the next frame.
+ */
+
+void span_buffer_reset(SpanBuffer* buffer) {
+    for (int row = 0; row < buffer->rows; row++)
+        buffer->rowSpans[row].count = 0;
+
+    buffer->fullRows = 0;
+}
+
+/**
+ * @brief Finds the first span of a row that ends at or after x, so it overlaps or touches pixels from x on.
+ */
+
+static int span_row_search(const SpanRow* row, int x) {
+    int low = 0, high = row->count;
+
+    while (low < high) {
+        int middle = (low + high) / 2;
+        if (row->spans[middle].end < x)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+/**
+ * @brief Covers the pixels [x0, x1) of a row and reports which of them were uncovered before.
+ *
+ * The new span is merged with every span it overlaps or touches, so the row stays a short sorted list.
+ *
+ * @param buffer The span buffer.
+ * @param row The row, must lie within the buffer.
+ * @param x0 First pixel, must not be negative.
+ * @param x1 Pixel after the last pixel, must not exceed the width.
+ * @return Number of uncovered spans written to buffer->visible, valid until the next insert.
+ */
+
+int span_buffer_insert(SpanBuffer* buffer, int row, int x0, int x1) {
+    if (x0 >= x1)
+        return 0;
+
+    SpanRow* spans = &buffer->rowSpans[row];
+    int first = span_row_search(spans, x0);
+
+    int visibleCount = 0;
+    int cursor = x0;
+    int last = first;
+
+    // Emit the gaps between the spans overlapping or touching [x0, x1)
+    while (last < spans->count && spans->spans[last].start <= x1) {
+        const Span* span = &spans->spans[last];
+
+        if (span->start > cursor)
+            buffer->visible[visibleCount++] = (Span) {(int16_t) cursor, span->start};
+
+        if (span->end > cursor)
+            cursor = span->end;
+
+        last++;
+    }
+
+    if (cursor < x1)
+        buffer->visible[visibleCount++] = (Span) {(int16_t) cursor, (int16_t) x1};
+
+    if (visibleCount == 0)
+        return 0;
+
+    int merged = last - first;
+
+    if (merged == 0) {
+        memmove(&spans->spans[first + 1], &spans->spans[first], sizeof(Span) * (spans->count - first));
+        spans->spans[first] = (Span) {(int16_t) x0, (int16_t) x1};
+        spans->count++;
+    } else {
+        Span combined = {
+                x0 < spans->spans[first].start ? (int16_t) x0 : spans->spans[first].start,
+                x1 > spans->spans[last - 1].end ? (int16_t) x1 : spans->spans[last - 1].end
+        };
+
+        spans->spans[first] = combined;
+        memmove(&spans->spans[first + 1], &spans->spans[last], sizeof(Span) * (spans->count - last));
+        spans->count -= merged - 1;
+    }
+
+    if (spans->count == 1 && spans->spans[0].start <= 0 && spans->spans[0].end >= buffer->width)
+        buffer->fullRows++;
+
+    return visibleCount;
+}
+
+/**
+ * @brief Covers a single pixel.
+ *
+ * @return 1 if the pixel was uncovered before, 0 otherwise.
+ */
+
+int span_buffer_insert_pixel(SpanBuffer* buffer, int row, int x) {
+    return span_buffer_insert(buffer, row, x, x + 1) > 0;
+}
@@ -0,0 +1,51 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#ifndef INC_3D_SPAN_BUFFER_H
+#define INC_3D_SPAN_BUFFER_H
+
+#include <stdint.h>
+
+/**
+ * Pixels [start, end) of a row.
+ */
+typedef struct {
+    int16_t start;
+    int16_t end;
+} Span;
+
+typedef struct {
+    int count;
+    int capacity;
+    Span* spans;    // Sorted, disjoint and never touching
+} SpanRow;
+
+/**
+ * Covered pixels of every frame row, stored as lists of intervals. Drawing front to back through the buffer
+ * writes every pixel at most once per frame.
+ */
+typedef struct {
+    int rows;
+    int width;
+    int fullRows;       // Rows covered from the first to the last pixel
+    SpanRow* rowSpans;
+    Span* visible;      // Uncovered parts found by the last insert
+    Span* storage;      // The spans of all rows
+} SpanBuffer;
+
+void span_buffer_init(SpanBuffer* buffer, int rows, int width);
+
+void span_buffer_destroy(SpanBuffer* buffer);
+
+void span_buffer_reset(SpanBuffer* buffer);
+
+int span_buffer_insert(SpanBuffer* buffer, int row, int x0, int x1);
+
+int span_buffer_insert_pixel(SpanBuffer* buffer, int row, int x);
+
+static inline int span_buffer_is_full(const SpanBuffer* buffer) {
+    return buffer->fullRows == buffer->rows;
+}
+
+#endif //INC_3D_SPAN_BUFFER_H
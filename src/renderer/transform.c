@@ -0,0 +1,437 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#include <math.h>
+#include "transform.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define TRANSFORM_BACKEND "avx"
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TRANSFORM_BACKEND "sse2"
+#elif defined(__ARM_ARCH_7EM__) && defined(__ARM_FEATURE_FMA)
+#define TRANSFORM_BACKEND "cortex-m7-fpu"
+#else
+#define TRANSFORM_BACKEND "scalar"
+#endif
+
+// Same threshold as vector3_multiply_matrix4x4, points with a smaller |w| are not divided
+#define TRANSFORM_W_THRESHOLD 0.0001f
+
+/**
+ * @brief Transforms points one at a time with a single reciprocal per point.
+ *
+ * The matrix is loaded into locals once, so the compiler can keep all twelve used terms in registers
+ * instead of reloading them through the pointer for every point.
+ */
+
+void transform_points_scalar(
+        const Matrix4x4* matrix,
+        const float* inX, const float* inY, const float* inZ,
+        float* outX, float* outY, float* outZ,
+        int count
+) {
+    const float m00 = matrix->m[0][0], m01 = matrix->m[0][1], m02 = matrix->m[0][2], m03 = matrix->m[0][3];
+    const float m10 = matrix->m[1][0], m11 = matrix->m[1][1], m12 = matrix->m[1][2], m13 = matrix->m[1][3];
+    const float m20 = matrix->m[2][0], m21 = matrix->m[2][1], m22 = matrix->m[2][2], m23 = matrix->m[2][3];
+    const float m30 = matrix->m[3][0], m31 = matrix->m[3][1], m32 = matrix->m[3][2], m33 = matrix->m[3][3];
+
+    for (int i = 0; i < count; i++) {
+        float x = inX[i], y = inY[i], z = inZ[i];
+
+        float w = x * m03 + y * m13 + z * m23 + m33;
+        float inverse = fabsf(w) > TRANSFORM_W_THRESHOLD ? 1.0f / w : 1.0f;
+
+        outX[i] = (x * m00 + y * m10 + z * m20 + m30) * inverse;
+        outY[i] = (x * m01 + y * m11 + z * m21 + m31) * inverse;
+        outZ[i] = (x * m02 + y * m12 + z * m22 + m32) * inverse;
+    }
+}
+
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64)
+
+/**
+ * @brief Transforms four points per iteration with SSE.
+ */
+
+static int transform_points_sse(
+        const Matrix4x4* matrix,
+        const float* inX, const float* inY, const float* inZ,
+        float* outX, float* outY, float* outZ,
+        int count
+) {
+    __m128 m[4][4];
+    for (int row = 0; row < 4; row++)
+        for (int column = 0; column < 4; column++)
+            m[row][column] = _mm_set1_ps(matrix->m[row][column]);
+
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 threshold = _mm_set1_ps(TRANSFORM_W_THRESHOLD);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(inX + i);
+        __m128 y = _mm_loadu_ps(inY + i);
+        __m128 z = _mm_loadu_ps(inZ + i);
+
+        __m128 w = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[0][3]), _mm_mul_ps(y, m[1][3])),
+                              _mm_add_ps(_mm_mul_ps(z, m[2][3]), m[3][3]));
+
+        __m128 divide = _mm_cmpgt_ps(_mm_and_ps(w, absMask), threshold);
+        __m128 inverse = _mm_or_ps(_mm_and_ps(divide, _mm_div_ps(one, w)), _mm_andnot_ps(divide, one));
+
+        __m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[0][0]), _mm_mul_ps(y, m[1][0])),
+                               _mm_add_ps(_mm_mul_ps(z, m[2][0]), m[3][0]));
+        __m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[0][1]), _mm_mul_ps(y, m[1][1])),
+                               _mm_add_ps(_mm_mul_ps(z, m[2][1]), m[3][1]));
+        __m128 rz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[0][2]), _mm_mul_ps(y, m[1][2])),
+                               _mm_add_ps(_mm_mul_ps(z, m[2][2]), m[3][2]));
+
+        _mm_storeu_ps(outX + i, _mm_mul_ps(rx, inverse));
+        _mm_storeu_ps(outY + i, _mm_mul_ps(ry, inverse));
+        _mm_storeu_ps(outZ + i, _mm_mul_ps(rz, inverse));
+    }
+
+    return i;
+}
+
+#endif
+
+#if defined(__AVX__)
+
+/**
+ * @brief Transforms eight points per iteration with AVX.
+ */
+
+static int transform_points_avx(
+        const Matrix4x4* matrix,
+        const float* inX, const float* inY, const float* inZ,
+        float* outX, float* outY, float* outZ,
+        int count
+) {
+    __m256 m[4][4];
+    for (int row = 0; row < 4; row++)
+        for (int column = 0; column < 4; column++)
+            m[row][column] = _mm256_set1_ps(matrix->m[row][column]);
+
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 threshold = _mm256_set1_ps(TRANSFORM_W_THRESHOLD);
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_loadu_ps(inX + i);
+        __m256 y = _mm256_loadu_ps(inY + i);
+        __m256 z = _mm256_loadu_ps(inZ + i);
+
+        __m256 w = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, m[0][3]), _mm256_mul_ps(y, m[1][3])),
+                                 _mm256_add_ps(_mm256_mul_ps(z, m[2][3]), m[3][3]));
+
+        __m256 divide = _mm256_cmp_ps(_mm256_and_ps(w, absMask), threshold, _CMP_GT_OQ);
+        __m256 inverse = _mm256_blendv_ps(one, _mm256_div_ps(one, w), divide);
+
+        __m256 rx = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, m[0][0]), _mm256_mul_ps(y, m[1][0])),
+                                  _mm256_add_ps(_mm256_mul_ps(z, m[2][0]), m[3][0]));
+        __m256 ry = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, m[0][1]), _mm256_mul_ps(y, m[1][1])),
+                                  _mm256_add_ps(_mm256_mul_ps(z, m[2][1]), m[3][1]));
+        __m256 rz = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, m[0][2]), _mm256_mul_ps(y, m[1][2])),
+                                  _mm256_add_ps(_mm256_mul_ps(z, m[2][2]), m[3][2]));
+
+        _mm256_storeu_ps(outX + i, _mm256_mul_ps(rx, inverse));
+        _mm256_storeu_ps(outY + i, _mm256_mul_ps(ry, inverse));
+        _mm256_storeu_ps(outZ + i, _mm256_mul_ps(rz, inverse));
+    }
+
+    return i;
+}
+
+#endif
+
+#if !defined(__AVX__) && !defined(__SSE2__) && !defined(_M_X64) && defined(__ARM_ARCH_7EM__) && defined(__ARM_FEATURE_FMA)
+
+/**
+ * @brief Transforms two points per iteration on the Cortex-M7.
+ *
+ * The M7 has no floating-point SIMD, its DSP extension only packs integers. Instead the loop is unrolled
+ * so the dual-issue pipeline can overlap two independent chains of fused multiply-adds, with all matrix
+ * terms held in the single-precision register file.
+ */
+
+static int transform_points_m7(
+        const Matrix4x4* matrix,
+        const float* inX, const float* inY, const float* inZ,
+        float* outX, float* outY, float* outZ,
+        int count
+) {
+    const float m00 = matrix->m[0][0], m01 = matrix->m[0][1], m02 = matrix->m[0][2], m03 = matrix->m[0][3];
+    const float m10 = matrix->m[1][0], m11 = matrix->m[1][1], m12 = matrix->m[1][2], m13 = matrix->m[1][3];
+    const float m20 = matrix->m[2][0], m21 = matrix->m[2][1], m22 = matrix->m[2][2], m23 = matrix->m[2][3];
+    const float m30 = matrix->m[3][0], m31 = matrix->m[3][1], m32 = matrix->m[3][2], m33 = matrix->m[3][3];
+
+    int i = 0;
+    for (; i + 2 <= count; i += 2) {
+        float x0 = inX[i], y0 = inY[i], z0 = inZ[i];
+        float x1 = inX[i + 1], y1 = inY[i + 1], z1 = inZ[i + 1];
+
+        float w0 = fmaf(x0, m03, fmaf(y0, m13, fmaf(z0, m23, m33)));
+        float w1 = fmaf(x1, m03, fmaf(y1, m13, fmaf(z1, m23, m33)));
+
+        float inverse0 = fabsf(w0) > TRANSFORM_W_THRESHOLD ? 1.0f / w0 : 1.0f;
+        float inverse1 = fabsf(w1) > TRANSFORM_W_THRESHOLD ? 1.0f / w1 : 1.0f;
+
+        outX[i] = fmaf(x0, m00, fmaf(y0, m10, fmaf(z0, m20, m30))) * inverse0;
+        outY[i] = fmaf(x0, m01, fmaf(y0, m11, fmaf(z0, m21, m31))) * inverse0;
+        outZ[i] = fmaf(x0, m02, fmaf(y0, m12, fmaf(z0, m22, m32))) * inverse0;
+
+        outX[i + 1] = fmaf(x1, m00, fmaf(y1, m10, fmaf(z1, m20, m30))) * inverse1;
+        outY[i + 1] = fmaf(x1, m01, fmaf(y1, m11, fmaf(z1, m21, m31))) * inverse1;
+        outZ[i + 1] = fmaf(x1, m02, fmaf(y1, m12, fmaf(z1, m22, m32))) * inverse1;
+    }
+
+    return i;
+}
+
+#endif
+
+/**
+ * @brief Transforms count points stored as structure-of-arrays by a 4x4 matrix.
+ *
+ * Produces the same result as calling vector3_multiply_matrix4x4 on every point, but computes a single
+ * reciprocal of w per point instead of three divisions and processes as many points per instruction as the
+ * target allows. Points left over by the vector loop are finished by the scalar path.
+ *
+ * @param matrix The 4x4 matrix.
+ * @param inX X-coordinates of the input points.
+ * @param inY Y-coordinates of the input points.
+ * @param inZ Z-coordinates of the input points.
+ * @param outX X-coordinates of the transformed points.
+ * @param outY Y-coordinates of the transformed points.
+ * @param outZ Z-coordinates of the transformed points.
+ * @param count Number of points.
+ */
+
+void transform_points(
+        const Matrix4x4* matrix,
+        const float* inX, const float* inY, const float* inZ,
+        float* outX, float* outY, float* outZ,
+        int count
+) {
+    int done = 0;
+
+#if defined(__AVX__)
+    done = transform_points_avx(matrix, inX, inY, inZ, outX, outY, outZ, count);
+#endif
+
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64)
+    done += transform_points_sse(
+            matrix,
+            inX + done, inY + done, inZ + done,
+            outX + done, outY + done, outZ + done,
+            count - done
+    );
+#elif defined(__ARM_ARCH_7EM__) && defined(__ARM_FEATURE_FMA)
+    done = transform_points_m7(matrix, inX, inY, inZ, outX, outY, outZ, count);
+#endif
+
+    transform_points_scalar(
+            matrix,
+            inX + done, inY + done, inZ + done,
+            outX + done, outY + done, outZ + done,
+            count - done
+    );
+}
+
+/**
+ * @brief Transforms points one at a time by an affine transformation, without a divide.
+ */
+
+void transform_points_affine_scalar(
+        const Matrix4x3* matrix,
+        const float* inX, const float* inY, const float* inZ,
+        float* outX, float* outY, float* outZ,
+        int count
+) {
+    const float m00 = matrix->m[0][0], m01 = matrix->m[0][1], m02 = matrix->m[0][2];
+    const float m10 = matrix->m[1][0], m11 = matrix->m[1][1], m12 = matrix->m[1][2];
+    const float m20 = matrix->m[2][0], m21 = matrix->m[2][1], m22 = matrix->m[2][2];
+    const float m30 = matrix->m[3][0], m31 = matrix->m[3][1], m32 = matrix->m[3][2];
+
+    for (int i = 0; i < count; i++) {
+        float x = inX[i], y = inY[i], z = inZ[i];
+
+        outX[i] = x * m00 + y * m10 + z * m20 + m30;
+        outY[i] = x * m01 + y * m11 + z * m21 + m31;
+        outZ[i] = x * m02 + y * m12 + z * m22 + m32;
+    }
+}
+
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64)
+
+/**
+ * @brief Transforms four points per iteration by an affine transformation with SSE.
+ */
+
+static int transform_points_affine_sse(
+        const Matrix4x3* matrix,
+        const float* inX, const float* inY, const float* inZ,
+        float* outX, float* outY, float* outZ,
+        int count
+) {
+    __m128 m[4][3];
+    for (int row = 0; row < 4; row++)
+        for (int column = 0; column < 3; column++)
+            m[row][column] = _mm_set1_ps(matrix->m[row][column]);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(inX + i);
+        __m128 y = _mm_loadu_ps(inY + i);
+        __m128 z = _mm_loadu_ps(inZ + i);
+
+        __m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[0][0]), _mm_mul_ps(y, m[1][0])),
+                               _mm_add_ps(_mm_mul_ps(z, m[2][0]), m[3][0]));
+        __m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[0][1]), _mm_mul_ps(y, m[1][1])),
+                               _mm_add_ps(_mm_mul_ps(z, m[2][1]), m[3][1]));
+        __m128 rz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[0][2]), _mm_mul_ps(y, m[1][2])),
+                               _mm_add_ps(_mm_mul_ps(z, m[2][2]), m[3][2]));
+
+        _mm_storeu_ps(outX + i, rx);
+        _mm_storeu_ps(outY + i, ry);
+        _mm_storeu_ps(outZ + i, rz);
+    }
+
+    return i;
+}
+
+#endif
+
+#if defined(__AVX__)
+
+/**
+ * @brief Transforms eight points per iteration by an affine transformation with AVX.
+ */
+
+static int transform_points_affine_avx(
+        const Matrix4x3* matrix,
+        const float* inX, const float* inY, const float* inZ,
+        float* outX, float* outY, float* outZ,
+        int count
+) {
+    __m256 m[4][3];
+    for (int row = 0; row < 4; row++)
+        for (int column = 0; column < 3; column++)
+            m[row][column] = _mm256_set1_ps(matrix->m[row][column]);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_loadu_ps(inX + i);
+        __m256 y = _mm256_loadu_ps(inY + i);
+        __m256 z = _mm256_loadu_ps(inZ + i);
+
+        __m256 rx = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, m[0][0]), _mm256_mul_ps(y, m[1][0])),
+                                  _mm256_add_ps(_mm256_mul_ps(z, m[2][0]), m[3][0]));
+        __m256 ry = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, m[0][1]), _mm256_mul_ps(y, m[1][1])),
+                                  _mm256_add_ps(_mm256_mul_ps(z, m[2][1]), m[3][1]));
+        __m256 rz = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, m[0][2]), _mm256_mul_ps(y, m[1][2])),
+                                  _mm256_add_ps(_mm256_mul_ps(z, m[2][2]), m[3][2]));
+
+        _mm256_storeu_ps(outX + i, rx);
+        _mm256_storeu_ps(outY + i, ry);
+        _mm256_storeu_ps(outZ + i, rz);
+    }
+
+    return i;
+}
+
+#endif
+
+#if !defined(__AVX__) && !defined(__SSE2__) && !defined(_M_X64) && defined(__ARM_ARCH_7EM__) && defined(__ARM_FEATURE_FMA)
+
+/**
+ * @brief Transforms two points per iteration by an affine transformation on the Cortex-M7, see
+ * transform_points_m7.
+ */
+
+static int transform_points_affine_m7(
+        const Matrix4x3* matrix,
+        const float* inX, const float* inY, const float* inZ,
+        float* outX, float* outY, float* outZ,
+        int count
+) {
+    const float m00 = matrix->m[0][0], m01 = matrix->m[0][1], m02 = matrix->m[0][2];
+    const float m10 = matrix->m[1][0], m11 = matrix->m[1][1], m12 = matrix->m[1][2];
+    const float m20 = matrix->m[2][0], m21 = matrix->m[2][1], m22 = matrix->m[2][2];
+    const float m30 = matrix->m[3][0], m31 = matrix->m[3][1], m32 = matrix->m[3][2];
+
+    int i = 0;
+    for (; i + 2 <= count; i += 2) {
+        float x0 = inX[i], y0 = inY[i], z0 = inZ[i];
+        float x1 = inX[i + 1], y1 = inY[i + 1], z1 = inZ[i + 1];
+
+        outX[i] = fmaf(x0, m00, fmaf(y0, m10, fmaf(z0, m20, m30)));
+        outY[i] = fmaf(x0, m01, fmaf(y0, m11, fmaf(z0, m21, m31)));
+        outZ[i] = fmaf(x0, m02, fmaf(y0, m12, fmaf(z0, m22, m32)));
+
+        outX[i + 1] = fmaf(x1, m00, fmaf(y1, m10, fmaf(z1, m20, m30)));
+        outY[i + 1] = fmaf(x1, m01, fmaf(y1, m11, fmaf(z1, m21, m31)));
+        outZ[i + 1] = fmaf(x1, m02, fmaf(y1, m12, fmaf(z1, m22, m32)));
+    }
+
+    return i;
+}
+
+#endif
+
+/**
+ * @brief Transforms count points stored as structure-of-arrays by an affine transformation.
+ *
+ * Needs nine multiplications per point and no divide, the path for anything that stays before the projection.
+ * Points left over by the vector loop are finished by the scalar path.
+ *
+ * @param matrix The affine transformation.
+ * @param inX X-coordinates of the input points.
+ * @param inY Y-coordinates of the input points.
+ * @param inZ Z-coordinates of the input points.
+ * @param outX X-coordinates of the transformed points.
+ * @param outY Y-coordinates of the transformed points.
+ * @param outZ Z-coordinates of the transformed points.
+ * @param count Number of points.
+ */
+
+void transform_points_affine(
+        const Matrix4x3* matrix,
+        const float* inX, const float* inY, const float* inZ,
+        float* outX, float* outY, float* outZ,
+        int count
+) {
+    int done = 0;
+
+#if defined(__AVX__)
+    done = transform_points_affine_avx(matrix, inX, inY, inZ, outX, outY, outZ, count);
+#endif
+
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64)
+    done += transform_points_affine_sse(
+            matrix,
+            inX + done, inY + done, inZ + done,
+            outX + done, outY + done, outZ + done,
+            count - done
+    );
+#elif defined(__ARM_ARCH_7EM__) && defined(__ARM_FEATURE_FMA)
+    done = transform_points_affine_m7(matrix, inX, inY, inZ, outX, outY, outZ, count);
+#endif
+
+    transform_points_affine_scalar(
+            matrix,
+            inX + done, inY + done, inZ + done,
+            outX + done, outY + done, outZ + done,
+            count - done
+    );
+}
+
+const char* transform_backend(void) {
+    return TRANSFORM_BACKEND;
+}
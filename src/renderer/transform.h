@@ -0,0 +1,75 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#ifndef INC_3D_TRANSFORM_H
+#define INC_3D_TRANSFORM_H
+
+#include "matrix4x3.h"
+
+/**
+ * Transforms count points stored as structure-of-arrays by a 4x4 matrix, including the perspective divide.
+ * Input and output arrays may alias.
+ *
+ * @param matrix The 4x4 matrix.
+ * @param inX X-coordinates of the input points.
+ * @param inY Y-coordinates of the input points.
+ * @param inZ Z-coordinates of the input points.
+ * @param outX X-coordinates of the transformed points.
+ * @param outY Y-coordinates of the transformed points.
+ * @param outZ Z-coordinates of the transformed points.
+ * @param count Number of points.
+ */
+void transform_points(
+        const Matrix4x4* matrix,
+        const float* inX, const float* inY, const float* inZ,
+        float* outX, float* outY, float* outZ,
+        int count
+);
+
+/**
+ * Portable scalar version of transform_points, always available for reference and testing.
+ */
+void transform_points_scalar(
+        const Matrix4x4* matrix,
+        const float* inX, const float* inY, const float* inZ,
+        float* outX, float* outY, float* outZ,
+        int count
+);
+
+/**
+ * Transforms count points stored as structure-of-arrays by an affine transformation. There is no w, so unlike
+ * transform_points nothing is divided. Input and output arrays may alias.
+ *
+ * @param matrix The affine transformation.
+ * @param inX X-coordinates of the input points.
+ * @param inY Y-coordinates of the input points.
+ * @param inZ Z-coordinates of the input points.
+ * @param outX X-coordinates of the transformed points.
+ * @param outY Y-coordinates of the transformed points.
+ * @param outZ Z-coordinates of the transformed points.
+ * @param count Number of points.
+ */
+void transform_points_affine(
+        const Matrix4x3* matrix,
+        const float* inX, const float* inY, const float* inZ,
+        float* outX, float* outY, float* outZ,
+        int count
+);
+
+/**
+ * Portable scalar version of transform_points_affine, always available for reference and testing.
+ */
+void transform_points_affine_scalar(
+        const Matrix4x3* matrix,
+        const float* inX, const float* inY, const float* inZ,
+        float* outX, float* outY, float* outZ,
+        int count
+);
+
+/**
+ * @return The name of the code path transform_points was compiled with.
+ */
+const char* transform_backend(void);
+
+#endif //INC_3D_TRANSFORM_H
@@ -0,0 +1,15 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#ifndef INC_3D_VECTOR4_H
+#define INC_3D_VECTOR4_H
+
+/**
+ * Homogeneous point, used for clip-space positions before the perspective divide.
+ */
+typedef struct {
+    float x, y, z, w;
+} Vector4;
+
+#endif //INC_3D_VECTOR4_H
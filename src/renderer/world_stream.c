@@ -0,0 +1,346 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#include <string.h>
+#include "world_stream.h"
+#include "memory.h"
+
+static const char* world_stream_read_table(WorldStream* stream, uint32_t fileSize);
+
+static float world_stream_distance(const WorldChunk* chunk, Vector3 viewer);
+
+static WorldChunk* world_stream_nearest(const WorldStream* stream, Vector3 viewer, float radius);
+
+static int world_stream_make_room(WorldStream* stream, const WorldChunk* chunk, Vector3 viewer);
+
+static int world_stream_begin(WorldStream* stream, WorldChunk* chunk);
+
+static void world_stream_finish(WorldStream* stream, WorldChunk* chunk);
+
+static void world_stream_cancel(WorldStream* stream, WorldChunk* chunk, WorldChunkState state);
+
+static void world_stream_evict(WorldStream* stream, WorldChunk* chunk);
+
+/**
+ * @brief Opens a world file and reads its chunk table, no chunk is loaded yet.
+ *
+ * @param stream The stream to initialize.
+ * @param api The PlaydateAPI used to read the file.
+ * @param path The file, in the data folder or the game bundle.
+ * @param scene The scene loaded chunks are added to.
+ * @param parent The node chunks are added to, the chunks are in its space.
+ * @param budget Bytes the loaded chunks may use.
+ * @return 1 on success, 0 if the file couldn't be read or is not a valid world file. The reason is logged.
+ */
+
+int world_stream_open(WorldStream* stream, PlaydateAPI* api, const char* path, Scene* scene, SceneNode* parent, int budget) {
+    const struct playdate_file* files = api->file;
+
+    memset(stream, 0, sizeof(WorldStream));
+    stream->api = api;
+    stream->scene = scene;
+    stream->parent = parent;
+    stream->budget = budget;
+
+    FileStat info;
+    if (files->stat(path, &info) != 0 || (stream->handle = files->open(path, kFileRead | kFileReadData)) == NULL) {
+        api->system->logToConsole("Couldn't open world %s: %s", path, files->geterr());
+        return 0;
+    }
+
+    const char* error = world_stream_read_table(stream, info.size);
+    if (error != NULL) {
+        api->system->logToConsole("Couldn't load world %s: %s", path, error);
+        world_stream_close(stream);
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Removes every loaded chunk from the scene, frees them and closes the file.
+ */
+
+void world_stream_close(WorldStream* stream) {
+    for (int i = 0; i < stream->chunkCount; i++) {
+        WorldChunk* chunk = &stream->chunks[i];
+
+        if (chunk->state == WORLD_CHUNK_LOADED)
+            world_stream_evict(stream, chunk);
+        else if (chunk->state == WORLD_CHUNK_LOADING)
+            world_stream_cancel(stream, chunk, WORLD_CHUNK_UNLOADED);
+    }
+
+    if (stream->handle != NULL)
+        stream->api->file->close(stream->handle);
+
+    memory_free(stream->chunks);
+    stream->handle = NULL;
+    stream->chunks = NULL;
+    stream->chunkCount = 0;
+}
+
+/**
+ * @brief Reads chunks near the viewer until the time is up, a chunk is added to the scene once it is read
+ * completely.
+ *
+ * A chunk that leaves the range while it is read is dropped. Loaded chunks out of range stay until their
+ * memory is needed.
+ *
+ * @param stream The stream.
+ * @param viewer Position of the viewer in the space of the parent node.
+ * @param radius Chunks whose bounds are closer to the viewer than this are loaded.
+ * @param time Seconds the update may spend reading, 0 for a single step.
+ * @return Number of chunks added to or removed from the scene. Any change invalidates images of the scene.
+ */
+
+int world_stream_update(WorldStream* stream, Vector3 viewer, float radius, float time) {
+    const struct playdate_file* files = stream->api->file;
+    float start = stream->api->system->getElapsedTime();
+
+    stream->frame++;
+    stream->changes = 0;
+    stream->idle = 0;
+
+    for (int i = 0; i < stream->chunkCount; i++) {
+        if (world_stream_distance(&stream->chunks[i], viewer) <= radius)
+            stream->chunks[i].lastUsed = stream->frame;
+    }
+
+    if (stream->loading != NULL && stream->loading->lastUsed != stream->frame)
+        world_stream_cancel(stream, stream->loading, WORLD_CHUNK_UNLOADED);
+
+    do {
+        if (stream->loading == NULL) {
+            WorldChunk* next = world_stream_nearest(stream, viewer, radius);
+            if (next == NULL || !world_stream_make_room(stream, next, viewer)) {
+                stream->idle = 1;
+                break;
+            }
+
+            // Out of memory or a broken chunk, the next update goes on
+            if (!world_stream_begin(stream, next)) {
+                stream->idle = 1;
+                break;
+            }
+
+            continue;
+        }
+
+        WorldChunk* chunk = stream->loading;
+        uint32_t remaining = chunk->entry.size - chunk->bytesRead;
+        int read = files->read(stream->handle, chunk->data + chunk->bytesRead,
+                               remaining < WORLD_STREAM_READ_SIZE ? remaining : WORLD_STREAM_READ_SIZE);
+
+        if (read <= 0) {
+            stream->api->system->logToConsole("Couldn't read world chunk %d: %s", (int) (chunk - stream->chunks),
+                                              files->geterr());
+            world_stream_cancel(stream, chunk, WORLD_CHUNK_FAILED);
+            continue;
+        }
+
+        chunk->bytesRead += read;
+        if (chunk->bytesRead == chunk->entry.size)
+            world_stream_finish(stream, chunk);
+    } while (stream->api->system->getElapsedTime() - start < time);
+
+    return stream->changes;
+}
+
+/**
+ * @brief Reads and checks the header and the chunk table.
+ *
+ * @return NULL if the file is valid, otherwise the reason it isn't.
+ */
+
+static const char* world_stream_read_table(WorldStream* stream, uint32_t fileSize) {
+    const struct playdate_file* files = stream->api->file;
+    WorldFileHeader header;
+
+    if (files->read(stream->handle, &header, sizeof(WorldFileHeader)) != sizeof(WorldFileHeader) ||
+        memcmp(header.magic, WORLD_FILE_MAGIC, 4) != 0)
+        return "not a world file";
+    if (header.version != WORLD_FILE_VERSION || header.headerSize != sizeof(WorldFileHeader))
+        return "unsupported version";
+    if (header.fileSize != fileSize)
+        return "truncated";
+    if (header.chunkCount == 0 || header.chunkCount > INT32_MAX / sizeof(WorldFileChunk) ||
+        (uint64_t) header.chunkOffset + header.chunkCount * sizeof(WorldFileChunk) > fileSize)
+        return "chunk table outside of the file";
+
+    stream->bounds = header.bounds;
+    stream->chunks = memory_calloc(header.chunkCount, sizeof(WorldChunk));
+    if (stream->chunks == NULL)
+        return "out of memory";
+
+    stream->chunkCount = (int) header.chunkCount;
+
+    int tableSize = (int) (header.chunkCount * sizeof(WorldFileChunk));
+    WorldFileChunk* table = memory_alloc(tableSize);
+    if (table == NULL)
+        return "out of memory";
+
+    int read = -1;
+    if (files->seek(stream->handle, (int) header.chunkOffset, SEEK_SET) == 0)
+        read = files->read(stream->handle, table, tableSize);
+
+    const char* error = read == tableSize ? NULL : "chunk table outside of the file";
+    for (int i = 0; error == NULL && i < stream->chunkCount; i++) {
+        if (table[i].size < sizeof(MeshFileHeader) || (uint64_t) table[i].offset + table[i].size > fileSize)
+            error = "chunk outside of the file";
+
+        stream->chunks[i].entry = table[i];
+    }
+
+    memory_free(table);
+    return error;
+}
+
+/**
+ * @brief Distance from the viewer to the bounds of a chunk, negative inside of them.
+ */
+
+static float world_stream_distance(const WorldChunk* chunk, Vector3 viewer) {
+    return vector3_length(vector3_subtract(chunk->entry.bounds.center, viewer)) - chunk->entry.bounds.radius;
+}
+
+static WorldChunk* world_stream_nearest(const WorldStream* stream, Vector3 viewer, float radius) {
+    WorldChunk* nearest = NULL;
+    float nearestDistance = radius;
+
+    for (int i = 0; i < stream->chunkCount; i++) {
+        WorldChunk* chunk = &stream->chunks[i];
+        if (chunk->state != WORLD_CHUNK_UNLOADED || chunk->entry.size > (uint32_t) stream->budget)
+            continue;
+
+        float distance = world_stream_distance(chunk, viewer);
+        if (distance <= nearestDistance) {
+            nearest = chunk;
+            nearestDistance = distance;
+        }
+    }
+
+    return nearest;
+}
+
+/**
+ * @brief Evicts loaded chunks until a chunk fits into the budget.
+ *
+ * Chunks out of range go first, least recently used first. Chunks in range are only evicted for a chunk nearer
+ * to the viewer, the furthest first.
+ *
+ * @return 1 if the chunk fits, 0 if it doesn't without evicting nearer chunks. Nothing is evicted then.
+ */
+
+static int world_stream_make_room(WorldStream* stream, const WorldChunk* chunk, Vector3 viewer) {
+    float chunkDistance = world_stream_distance(chunk, viewer);
+    int freeable = stream->budget - stream->bytesUsed;
+
+    // Check first, so chunks aren't evicted for nothing
+    for (int i = 0; i < stream->chunkCount && freeable < (int) chunk->entry.size; i++) {
+        const WorldChunk* other = &stream->chunks[i];
+
+        if (other->state == WORLD_CHUNK_LOADED &&
+            (other->lastUsed != stream->frame || world_stream_distance(other, viewer) > chunkDistance))
+            freeable += (int) other->entry.size;
+    }
+
+    if (freeable < (int) chunk->entry.size)
+        return 0;
+
+    while (stream->bytesUsed + (int) chunk->entry.size > stream->budget) {
+        WorldChunk* victim = NULL;
+        float victimDistance = 0.0f;
+
+        for (int i = 0; i < stream->chunkCount; i++) {
+            WorldChunk* other = &stream->chunks[i];
+            if (other->state != WORLD_CHUNK_LOADED)
+                continue;
+
+            float distance = world_stream_distance(other, viewer);
+            if (other->lastUsed == stream->frame && distance <= chunkDistance)
+                continue;
+
+            if (victim == NULL || other->lastUsed < victim->lastUsed ||
+                (other->lastUsed == victim->lastUsed && distance > victimDistance)) {
+                victim = other;
+                victimDistance = distance;
+            }
+        }
+
+        world_stream_evict(stream, victim);
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Starts reading a chunk.
+ *
+ * @return 1 if the chunk is being read, 0 if it failed for good or has to wait until its data fits the heap.
+ */
+
+static int world_stream_begin(WorldStream* stream, WorldChunk* chunk) {
+    if (stream->api->file->seek(stream->handle, (int) chunk->entry.offset, SEEK_SET) != 0) {
+        stream->api->system->logToConsole("Couldn't seek to world chunk %d: %s", (int) (chunk - stream->chunks),
+                                          stream->api->file->geterr());
+        chunk->state = WORLD_CHUNK_FAILED;
+        return 0;
+    }
+
+    chunk->data = memory_alloc(chunk->entry.size);
+    if (chunk->data == NULL) {
+        chunk->state = WORLD_CHUNK_UNLOADED;
+        return 0;
+    }
+
+    chunk->state = WORLD_CHUNK_LOADING;
+    chunk->bytesRead = 0;
+    stream->loading = chunk;
+    stream->bytesUsed += (int) chunk->entry.size;
+    return 1;
+}
+
+static void world_stream_finish(WorldStream* stream, WorldChunk* chunk) {
+    stream->loading = NULL;
+
+    // The mesh file owns the data from here on and frees it on failure
+    uint8_t* data = chunk->data;
+    chunk->data = NULL;
+
+    if (!mesh_file_load_buffer(&chunk->file, stream->api, data, chunk->entry.size, "world chunk")) {
+        chunk->state = WORLD_CHUNK_FAILED;
+        stream->bytesUsed -= (int) chunk->entry.size;
+        return;
+    }
+
+    chunk->node = scene_add(stream->scene, stream->parent, &chunk->file.mesh);
+    if (chunk->node == NULL) {
+        mesh_file_unload(&chunk->file);
+        chunk->state = WORLD_CHUNK_FAILED;
+        stream->bytesUsed -= (int) chunk->entry.size;
+        return;
+    }
+
+    chunk->state = WORLD_CHUNK_LOADED;
+    stream->changes++;
+}
+
+static void world_stream_cancel(WorldStream* stream, WorldChunk* chunk, WorldChunkState state) {
+    memory_free(chunk->data);
+    chunk->data = NULL;
+    chunk->state = state;
+    stream->loading = NULL;
+    stream->bytesUsed -= (int) chunk->entry.size;
+}
+
+static void world_stream_evict(WorldStream* stream, WorldChunk* chunk) {
+    scene_remove(stream->scene, chunk->node);
+    mesh_file_unload(&chunk->file);
+    chunk->node = NULL;
+    chunk->state = WORLD_CHUNK_UNLOADED;
+    stream->bytesUsed -= (int) chunk->entry.size;
+    stream->changes++;
+}
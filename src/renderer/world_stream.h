@@ -0,0 +1,90 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#ifndef INC_3D_WORLD_STREAM_H
+#define INC_3D_WORLD_STREAM_H
+
+#include <stdint.h>
+#include "pd_api.h"
+#include "mesh_file.h"
+#include "scene.h"
+
+#define WORLD_FILE_MAGIC "P3DW"
+#define WORLD_FILE_VERSION 1
+
+// Bytes read from the file at once, the time budget is checked between two reads
+#define WORLD_STREAM_READ_SIZE 4096
+
+/**
+ * Header at the start of a world file, written by tools/bake_mesh.py --chunks. The world is split into spatial
+ * chunks, each stored as a complete binary mesh file so it can be loaded on its own.
+ */
+typedef struct {
+    char magic[4];          // WORLD_FILE_MAGIC
+    uint16_t version;       // WORLD_FILE_VERSION
+    uint16_t headerSize;    // sizeof(WorldFileHeader)
+    uint32_t chunkCount;
+    BoundingSphere bounds;  // Of the whole world
+    uint32_t chunkOffset;   // chunkCount WorldFileChunk
+    uint32_t fileSize;
+} WorldFileHeader;
+
+_Static_assert(sizeof(WorldFileHeader) == 36, "WorldFileHeader must match the file layout");
+
+typedef struct {
+    BoundingSphere bounds;
+    uint32_t offset;        // Binary mesh file of the chunk, see MeshFileHeader
+    uint32_t size;
+} WorldFileChunk;
+
+_Static_assert(sizeof(WorldFileChunk) == 24, "WorldFileChunk must match the file layout");
+
+typedef enum {
+    WORLD_CHUNK_UNLOADED,
+    WORLD_CHUNK_LOADING,
+    WORLD_CHUNK_LOADED,
+    WORLD_CHUNK_FAILED,     // Not a valid mesh, never tried again
+} WorldChunkState;
+
+typedef struct {
+    WorldFileChunk entry;
+    WorldChunkState state;
+    uint8_t* data;          // While loading, owned by the mesh file once loaded
+    uint32_t bytesRead;
+    MeshFile file;
+    SceneNode* node;        // NULL unless loaded
+    int lastUsed;           // Update the chunk was last in range
+} WorldChunk;
+
+/**
+ * Loads the chunks of a world file near a viewer into a scene a few kilobytes at a time, so a world larger than
+ * the memory budget is drawn without stalling the update. Chunks are read in the order of their distance. When
+ * the budget is full, the least recently used chunks are evicted first, and of chunks still in range the ones
+ * furthest away.
+ */
+typedef struct {
+    PlaydateAPI* api;
+    SDFile* handle;         // Kept open, chunks are read with seek and read
+    Scene* scene;
+    SceneNode* parent;      // Chunks are added as its children
+
+    BoundingSphere bounds;
+    int chunkCount;
+    WorldChunk* chunks;     // NULL unless a world is open
+    WorldChunk* loading;    // Chunk being read, NULL if none
+
+    int budget;             // Bytes the loaded and loading chunks may use
+    int bytesUsed;
+    int frame;
+    int changes;            // Chunks added to or removed from the scene during the last update
+    int idle;               // The last update found no chunk to load
+} WorldStream;
+
+int world_stream_open(WorldStream* stream, PlaydateAPI* api, const char* path, Scene* scene, SceneNode* parent, int budget);
+
+void world_stream_close(WorldStream* stream);
+
+int world_stream_update(WorldStream* stream, Vector3 viewer, float radius, float time);
+
+#endif //INC_3D_WORLD_STREAM_H
@@ -0,0 +1,159 @@
+//
+// Created by Michael Berger on 10/16/26.
+//
+
+#include <stdio.h>
+#include <string.h>
+
+// The codec is static, the test is built with its own copy of the cache
+#include "frame_cache.c"
+
+// Untouched bytes behind every buffer, an overrun shows up as a changed canary
+#define TEST_CANARY 16
+#define TEST_CANARY_BYTE 0xA5
+#define TEST_MAX_LENGTH 4096
+
+static int failures = 0;
+
+static void check(int condition, const char* name, const char* what) {
+    if (!condition) {
+        printf("FAIL %s: %s\n", name, what);
+        failures++;
+    }
+}
+
+static int canary_intact(const uint8_t* canary) {
+    for (int i = 0; i < TEST_CANARY; i++)
+        if (canary[i] != TEST_CANARY_BYTE)
+            return 0;
+    return 1;
+}
+
+/**
+ * @brief Encodes and decodes a buffer and checks the result, the worst case bound and both buffer ends.
+ */
+
+static void check_round_trip(const char* name, const uint8_t* in, int length) {
+    static uint8_t encoded[TEST_MAX_LENGTH + TEST_MAX_LENGTH / FRAME_CACHE_MAX_RUN + 1 + TEST_CANARY];
+    static uint8_t decoded[TEST_MAX_LENGTH + TEST_CANARY];
+
+    int bound = length + (length + FRAME_CACHE_MAX_RUN - 1) / FRAME_CACHE_MAX_RUN;
+    memset(encoded, TEST_CANARY_BYTE, sizeof(encoded));
+    memset(decoded, TEST_CANARY_BYTE, sizeof(decoded));
+
+    int size = frame_cache_encode(in, length, encoded);
+    check(size <= bound, name, "encoded size above length + ceil(length / 128)");
+    check(canary_intact(encoded + bound), name, "encoder wrote past the worst case bound");
+
+    frame_cache_decode_runs(encoded, size, decoded);
+    check(memcmp(in, decoded, length) == 0, name, "decoded bytes differ");
+    check(canary_intact(decoded + length), name, "decoder wrote past the length");
+}
+
+/**
+ * @brief Round trips every pattern at lengths around the 128 byte limits of runs and literals.
+ */
+
+static void check_codec(void) {
+    static const int lengths[] = {1, 2, 127, 128, 129, 255, 256, 257, 384, 385, 3000, TEST_MAX_LENGTH};
+    static uint8_t in[TEST_MAX_LENGTH];
+    char name[64];
+
+    for (int l = 0; l < (int) (sizeof(lengths) / sizeof(lengths[0])); l++) {
+        int length = lengths[l];
+
+        memset(in, 0, length);
+        snprintf(name, sizeof(name), "all zero %d", length);
+        check_round_trip(name, in, length);
+
+        memset(in, 0x5A, length);
+        snprintf(name, sizeof(name), "all literal %d", length);
+        check_round_trip(name, in, length);
+
+        // Single zeros stay inside literals
+        for (int i = 0; i < length; i++)
+            in[i] = i % 2 == 0 ? 0xFF : 0;
+        snprintf(name, sizeof(name), "alternating literal zero %d", length);
+        check_round_trip(name, in, length);
+
+        // Full literals each followed by a single zero, the worst case of the coder
+        for (int i = 0; i < length; i++)
+            in[i] = i % (FRAME_CACHE_MAX_RUN + 1) == FRAME_CACHE_MAX_RUN ? 0 : 0x0F;
+        snprintf(name, sizeof(name), "full literal single zero %d", length);
+        check_round_trip(name, in, length);
+
+        // Zero runs of 128 and 129 bytes between literals
+        for (int run = FRAME_CACHE_MAX_RUN; run <= FRAME_CACHE_MAX_RUN + 1; run++) {
+            for (int i = 0; i < length; i++)
+                in[i] = i % (run + 3) < run ? 0 : 0x81;
+            snprintf(name, sizeof(name), "zero run %d in %d", run, length);
+            check_round_trip(name, in, length);
+        }
+
+        // Literals of 128 and 129 bytes between zero pairs
+        for (int run = FRAME_CACHE_MAX_RUN; run <= FRAME_CACHE_MAX_RUN + 1; run++) {
+            for (int i = 0; i < length; i++)
+                in[i] = i % (run + 2) < run ? 0x42 : 0;
+            snprintf(name, sizeof(name), "literal %d in %d", run, length);
+            check_round_trip(name, in, length);
+        }
+
+        uint32_t state = 12345u + (uint32_t) length;
+        for (int i = 0; i < length; i++) {
+            state = state * 1664525u + 1013904223u;
+            in[i] = (state >> 24) < 64 ? (uint8_t) (state >> 16) : 0;
+        }
+        snprintf(name, sizeof(name), "random sparse %d", length);
+        check_round_trip(name, in, length);
+    }
+}
+
+/**
+ * @brief Stores frames into a cache much smaller than all of them and reads each back right away, so entries
+ * span pages and older entries get evicted.
+ */
+
+static void check_cache(void) {
+    static uint8_t frame[LCD_ROWS * LCD_ROWSIZE];
+    static uint8_t decoded[LCD_ROWS * LCD_ROWSIZE];
+    const int rows = 120, columns = 200, keys = 16;
+
+    FrameCache cache;
+    DirtyRegion drawn;
+    frame_cache_init(&cache, rows, columns, 360.0f / (float) keys, 8 * 1024);
+    dirty_region_init(&drawn, rows, columns);
+
+    for (int k = 0; k < 4 * keys; k++) {
+        int key = k % keys;
+        for (int i = 0; i < (int) sizeof(frame); i++)
+            frame[i] = (uint8_t) ((i * (k + 1) * 31) >> (k % 5));
+
+        frame_cache_store(&cache, key, frame);
+        const FrameCacheEntry* entry = frame_cache_find(&cache, key);
+        check(entry != NULL, "cache", "stored frame missing");
+        if (entry == NULL)
+            continue;
+
+        frame_cache_decode(&cache, entry, decoded, &drawn);
+        for (int row = 0; row < rows; row++)
+            check(memcmp(frame + row * LCD_ROWSIZE, decoded + row * LCD_ROWSIZE, cache.rowBytes) == 0, "cache", "decoded row differs");
+    }
+
+    check(cache.bytesUsed <= cache.budget, "cache", "budget exceeded");
+
+    dirty_region_destroy(&drawn);
+    frame_cache_destroy(&cache);
+}
+
+int main(void) {
+    check_codec();
+    check_cache();
+
+    if (failures > 0) {
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+
+    printf("all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,752 @@
+#!/usr/bin/env python3
+"""
+Bakes an OBJ or PLY mesh into a C source file holding the mesh as static const tables.
+
+    bake_mesh.py [--binary | --chunks <size>] [--lods <levels>] <input.obj|input.ply> <output directory>
+
+Writes <name>_mesh.h declaring `extern const Mesh <name>Mesh` and <name>_mesh.c defining it, where <name> is the
+file name of the input without its extension. With --binary it writes <name>.mesh instead, a binary mesh file that
+mesh_file_load maps straight into a Mesh at runtime (see src/renderer/mesh_file.h). With --chunks it writes
+<name>.world instead, the triangles split into cubes of <size> units by their centroid and every cube baked into its
+own binary mesh, streamed in by world_stream_update (see src/renderer/world_stream.h). Everything the renderer would otherwise compute at startup is done
+here: vertices at the same position are welded, degenerate triangles are dropped, triangles are reordered for the
+post-transform vertex cache and vertices are renumbered in the order the triangles first use them. Face planes and
+the bounding sphere are precomputed with the same formulas as mesh_compute_planes and bounding_sphere_from_points.
+
+Every mesh also gets a chain of up to <levels> - 1 coarser levels of detail (4 levels by default, 1 disables them),
+simplified by quadric edge collapse. Each level stores the projected radius in pixels below which the renderer draws
+it instead of the previous one, where its error stays under a pixel on the screen.
+"""
+
+import heapq
+import math
+import os
+import re
+import struct
+import sys
+
+# Positions closer than this along every axis are welded into one vertex
+WELD_EPSILON = 1e-5
+
+# Simulated post-transform cache of the triangle ordering
+CACHE_SIZE = 32
+CACHE_DECAY_POWER = 1.5
+LAST_TRIANGLE_SCORE = 0.75
+VALENCE_BOOST_SCALE = 2.0
+VALENCE_BOOST_POWER = 0.5
+
+# Levels of detail of a mesh, the mesh itself included, must match MESH_LOD_LEVELS in src/renderer/mesh.h
+LOD_LEVELS = 4
+# Every level keeps at most this share of the triangles of the previous one
+LOD_REDUCTION = 0.25
+# Triangles of the coarsest level, simplification doesn't go below
+LOD_MIN_TRIANGLES = 8
+# Share of the triangles a level has to save over the previous one to be worth storing
+LOD_MIN_SAVING = 0.25
+# Error of a level in pixels on the screen at its switch radius
+LOD_PIXEL_ERROR = 1.0
+# Switch radius of a level without any error
+LOD_MAX_RADIUS = 1e9
+# A collapse is rejected if it turns a face further than this, as the cosine between the old and the new normal
+LOD_FLIP_COSINE = 0.2
+
+# Must match MESH_FILE_MAGIC and MESH_FILE_VERSION in src/renderer/mesh_file.h
+MESH_FILE_MAGIC = b"P3DM"
+MESH_FILE_VERSION = 2
+
+# Must match WORLD_FILE_MAGIC and WORLD_FILE_VERSION in src/renderer/world_stream.h
+WORLD_FILE_MAGIC = b"P3DW"
+WORLD_FILE_VERSION = 1
+
+
+def fail(message):
+    sys.stderr.write("bake_mesh: %s\n" % message)
+    sys.exit(1)
+
+
+def fan(polygon):
+    """Splits a convex polygon into triangles sharing its first vertex."""
+    return [(polygon[0], polygon[i], polygon[i + 1]) for i in range(1, len(polygon) - 1)]
+
+
+def read_obj(path):
+    vertices, triangles = [], []
+
+    with open(path, "r") as file:
+        for number, line in enumerate(file, 1):
+            fields = line.split()
+            if not fields or fields[0].startswith("#"):
+                continue
+
+            if fields[0] == "v":
+                vertices.append(tuple(float(value) for value in fields[1:4]))
+            elif fields[0] == "f":
+                polygon = []
+                for field in fields[1:]:
+                    # v, v/vt, v//vn or v/vt/vn, negative indices count back from the last vertex
+                    index = int(field.split("/")[0])
+                    polygon.append(index - 1 if index > 0 else len(vertices) + index)
+
+                if len(polygon) < 3:
+                    fail("%s:%d: face with less than three vertices" % (path, number))
+                triangles.extend(fan(polygon))
+
+    return vertices, triangles
+
+
+def read_ply(path):
+    with open(path, "rb") as file:
+        if file.readline().strip() != b"ply":
+            fail("%s: not a PLY file" % path)
+
+        encoding, elements = None, []
+        while True:
+            line = file.readline()
+            if not line:
+                fail("%s: missing end_header" % path)
+
+            fields = line.decode("ascii").split()
+            if not fields or fields[0] in ("comment", "obj_info"):
+                continue
+            if fields[0] == "end_header":
+                break
+            if fields[0] == "format":
+                encoding = fields[1]
+            elif fields[0] == "element":
+                elements.append((fields[1], int(fields[2]), []))
+            elif fields[0] == "property":
+                elements[-1][2].append(fields[1:])
+
+        if encoding == "ascii":
+            tokens = iter(file.read().decode("ascii").split())
+            read = lambda kind: float(next(tokens)) if kind in ("float", "float32", "double", "float64") else int(next(tokens))
+        elif encoding in ("binary_little_endian", "binary_big_endian"):
+            order = "<" if encoding == "binary_little_endian" else ">"
+            formats = {"char": "b", "int8": "b", "uchar": "B", "uint8": "B", "short": "h", "int16": "h",
+                       "ushort": "H", "uint16": "H", "int": "i", "int32": "i", "uint": "I", "uint32": "I",
+                       "float": "f", "float32": "f", "double": "d", "float64": "d"}
+
+            def read(kind):
+                layout = order + formats[kind]
+                return struct.unpack(layout, file.read(struct.calcsize(layout)))[0]
+        else:
+            fail("%s: unsupported PLY format %s" % (path, encoding))
+
+        vertices, triangles = [], []
+        for name, count, properties in elements:
+            for _ in range(count):
+                values = {}
+                for property in properties:
+                    if property[0] == "list":
+                        values[property[3]] = [read(property[2]) for _ in range(read(property[1]))]
+                    else:
+                        values[property[1]] = read(property[0])
+
+                if name == "vertex":
+                    vertices.append((values["x"], values["y"], values["z"]))
+                elif name == "face":
+                    polygon = values.get("vertex_indices", values.get("vertex_index"))
+                    if polygon is None or len(polygon) < 3:
+                        fail("%s: face without vertex indices" % path)
+                    triangles.extend(fan(polygon))
+
+    return vertices, triangles
+
+
+def weld(vertices, triangles):
+    """Merges vertices at the same position, the first one of every position is kept."""
+    remap, cells, welded = [], {}, []
+
+    for vertex in vertices:
+        key = tuple(round(value / WELD_EPSILON) for value in vertex)
+        if key not in cells:
+            cells[key] = len(welded)
+            welded.append(vertex)
+        remap.append(cells[key])
+
+    return welded, [tuple(remap[index] for index in triangle) for triangle in triangles]
+
+
+def subtract(a, b):
+    return (a[0] - b[0], a[1] - b[1], a[2] - b[2])
+
+
+def cross(a, b):
+    return (a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0])
+
+
+def dot(a, b):
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]
+
+
+def remove_degenerate(vertices, triangles):
+    """Drops triangles that repeat a vertex or have no area."""
+    kept = []
+
+    for a, b, c in triangles:
+        if a == b or b == c or a == c:
+            continue
+        normal = cross(subtract(vertices[b], vertices[a]), subtract(vertices[c], vertices[a]))
+        if dot(normal, normal) <= 1e-20:
+            continue
+        kept.append((a, b, c))
+
+    return kept
+
+
+def vertex_score(position, remaining):
+    """Score of a vertex for the cache ordering, see Tom Forsyth's linear-speed vertex cache optimisation."""
+    if remaining == 0:
+        return -1.0
+
+    score = 0.0
+    if position >= 0:
+        if position < 3:
+            score = LAST_TRIANGLE_SCORE
+        else:
+            score = (1.0 - (position - 3) / (CACHE_SIZE - 3)) ** CACHE_DECAY_POWER
+
+    return score + VALENCE_BOOST_SCALE * remaining ** -VALENCE_BOOST_POWER
+
+
+def optimize_cache(vertex_count, triangles):
+    """Reorders the triangles so consecutive triangles share vertices while they are still in the cache."""
+    vertex_triangles = [[] for _ in range(vertex_count)]
+    for t, triangle in enumerate(triangles):
+        for index in triangle:
+            vertex_triangles[index].append(t)
+
+    remaining = [len(used) for used in vertex_triangles]
+    position = [-1] * vertex_count
+    score = [vertex_score(-1, remaining[v]) for v in range(vertex_count)]
+    triangle_score = [sum(score[v] for v in triangle) for triangle in triangles]
+    drawn = [False] * len(triangles)
+    cache, order = [], []
+
+    while len(order) < len(triangles):
+        # Best triangle touching the cache, otherwise the best one left
+        candidates = {t for v in cache for t in vertex_triangles[v] if not drawn[t]}
+        if not candidates:
+            candidates = (t for t in range(len(triangles)) if not drawn[t])
+        best = max(candidates, key=lambda t: triangle_score[t])
+
+        drawn[best] = True
+        order.append(best)
+
+        for v in triangles[best]:
+            remaining[v] -= 1
+            vertex_triangles[v].remove(best)
+
+        cache = list(triangles[best]) + [v for v in cache if v not in triangles[best]]
+        evicted = cache[CACHE_SIZE:]
+        cache = cache[:CACHE_SIZE]
+
+        for v in evicted:
+            position[v] = -1
+        for i, v in enumerate(cache):
+            position[v] = i
+
+        for v in set(cache + evicted):
+            new_score = vertex_score(position[v], remaining[v])
+            for t in vertex_triangles[v]:
+                triangle_score[t] += new_score - score[v]
+            score[v] = new_score
+
+    return [triangles[t] for t in order]
+
+
+def renumber(vertices, triangles):
+    """Stores the vertices in the order the triangles first use them, unused vertices are dropped."""
+    remap = {}
+    for triangle in triangles:
+        for index in triangle:
+            if index not in remap:
+                remap[index] = len(remap)
+
+    ordered = [None] * len(remap)
+    for old, new in remap.items():
+        ordered[new] = vertices[old]
+
+    return ordered, [tuple(remap[index] for index in triangle) for triangle in triangles]
+
+
+def planes(vertices, triangles):
+    """Unit normal and plane distance of every triangle, as mesh_compute_planes."""
+    result = []
+
+    for a, b, c in triangles:
+        normal = cross(subtract(vertices[b], vertices[a]), subtract(vertices[c], vertices[a]))
+        length = math.sqrt(dot(normal, normal))
+        normal = tuple(value / length for value in normal)
+        result.append((normal, -dot(normal, vertices[a])))
+
+    return result
+
+
+def bounding_sphere(vertices):
+    """Sphere around the center of the bounding box, as bounding_sphere_from_points."""
+    minimum = [min(vertex[axis] for vertex in vertices) for axis in range(3)]
+    maximum = [max(vertex[axis] for vertex in vertices) for axis in range(3)]
+    center = tuple((minimum[axis] + maximum[axis]) * 0.5 for axis in range(3))
+    radius = math.sqrt(max(dot(subtract(vertex, center), subtract(vertex, center)) for vertex in vertices))
+
+    # Rounding the tables to float must not leave a vertex outside
+    return center, radius * (1.0 + 1e-6)
+
+
+def plane_quadric(normal, distance):
+    """Upper triangle of the symmetric 4x4 matrix measuring the squared distance of a point to a plane."""
+    a, b, c = normal
+    d = distance
+    return (a * a, a * b, a * c, a * d, b * b, b * c, b * d, c * c, c * d, d * d)
+
+
+def add_quadrics(p, q):
+    return tuple(x + y for x, y in zip(p, q))
+
+
+def quadric_error(q, point):
+    x, y, z = point
+    return (q[0] * x * x + 2.0 * q[1] * x * y + 2.0 * q[2] * x * z + 2.0 * q[3] * x
+            + q[4] * y * y + 2.0 * q[5] * y * z + 2.0 * q[6] * y
+            + q[7] * z * z + 2.0 * q[8] * z + q[9])
+
+
+def triangle_distance(point, a, b, c):
+    """Distance of a point to the closest point of a triangle, see Ericson, Real-Time Collision Detection 5.1.5."""
+    ab, ac, ap = subtract(b, a), subtract(c, a), subtract(point, a)
+    d1, d2 = dot(ab, ap), dot(ac, ap)
+    if d1 <= 0.0 and d2 <= 0.0:
+        closest = a
+    else:
+        bp = subtract(point, b)
+        d3, d4 = dot(ab, bp), dot(ac, bp)
+        cp = subtract(point, c)
+        d5, d6 = dot(ab, cp), dot(ac, cp)
+        va, vb, vc = d3 * d6 - d5 * d4, d5 * d2 - d1 * d6, d1 * d4 - d3 * d2
+
+        if d3 >= 0.0 and d4 <= d3:
+            closest = b
+        elif d6 >= 0.0 and d5 <= d6:
+            closest = c
+        elif vc <= 0.0 and d1 >= 0.0 and d3 <= 0.0:
+            t = d1 / (d1 - d3)
+            closest = tuple(a[axis] + t * ab[axis] for axis in range(3))
+        elif vb <= 0.0 and d2 >= 0.0 and d6 <= 0.0:
+            t = d2 / (d2 - d6)
+            closest = tuple(a[axis] + t * ac[axis] for axis in range(3))
+        elif va <= 0.0 and d4 - d3 >= 0.0 and d5 - d6 >= 0.0:
+            t = (d4 - d3) / ((d4 - d3) + (d5 - d6))
+            closest = tuple(b[axis] + t * (c[axis] - b[axis]) for axis in range(3))
+        else:
+            denominator = 1.0 / (va + vb + vc)
+            v, w = vb * denominator, vc * denominator
+            closest = tuple(a[axis] + ab[axis] * v + ac[axis] * w for axis in range(3))
+
+    offset = subtract(point, closest)
+    return math.sqrt(dot(offset, offset))
+
+
+def simplify(vertices, triangles, targets):
+    """
+    Quadric edge collapse after Garland and Heckbert. Every vertex sums the planes of the faces around it and the
+    edge whose collapse moves the surface least is collapsed, until the triangle count reaches the next target. The
+    merged vertex moves to whichever of the two ends or the midpoint is nearest to all planes.
+
+    Vertices on open edges are locked, so neighbouring chunks of a world keep matching borders. Collapses that would
+    flip a face or pinch the surface into a non-manifold are rejected.
+
+    Returns the moved vertices and a (triangles, error) pair for every target reached. The error is the largest
+    distance of an original vertex to the faces around the vertex it was merged into, an upper bound of how far the
+    surface has moved. Stops early once no edge can collapse.
+    """
+    positions = list(vertices)
+    faces = [list(triangle) for triangle in triangles]
+    alive = [True] * len(faces)
+    live = len(faces)
+    vertex_faces = [set() for _ in positions]
+    quadrics = [(0.0,) * 10 for _ in positions]
+
+    for f, (normal, distance) in enumerate(planes(vertices, triangles)):
+        quadric = plane_quadric(normal, distance)
+        for v in faces[f]:
+            quadrics[v] = add_quadrics(quadrics[v], quadric)
+            vertex_faces[v].add(f)
+
+    edge_faces = {}
+    for face in faces:
+        for i in range(3):
+            edge = tuple(sorted((face[i], face[(i + 1) % 3])))
+            edge_faces[edge] = edge_faces.get(edge, 0) + 1
+    locked = {v for edge, count in edge_faces.items() if count == 1 for v in edge}
+
+    # Vertex every removed vertex was merged into
+    merged = list(range(len(positions)))
+
+    def survivor(v):
+        while merged[v] != v:
+            merged[v] = merged[merged[v]]
+            v = merged[v]
+        return v
+
+    # Queue entries are stale once either end has changed since they were pushed
+    version = [0] * len(positions)
+    heap = []
+
+    def push(keep, remove):
+        if remove in locked:
+            if keep in locked:
+                return
+            keep, remove = remove, keep
+
+        quadric = add_quadrics(quadrics[keep], quadrics[remove])
+        candidates = [positions[keep]]
+        if keep not in locked:
+            midpoint = tuple((positions[keep][axis] + positions[remove][axis]) * 0.5 for axis in range(3))
+            candidates += [positions[remove], midpoint]
+
+        cost, position = min((quadric_error(quadric, candidate), candidate) for candidate in candidates)
+        heapq.heappush(heap, (cost, keep, remove, version[keep], version[remove], position))
+
+    def neighbours(v):
+        return {u for f in vertex_faces[v] for u in faces[f] if u != v}
+
+    def flips(v, other, position):
+        """Whether moving v turns or collapses one of its faces that doesn't also hold other."""
+        for f in vertex_faces[v]:
+            face = faces[f]
+            if other in face:
+                continue
+
+            corners = [position if u == v else positions[u] for u in face]
+            before = cross(subtract(positions[face[1]], positions[face[0]]), subtract(positions[face[2]], positions[face[0]]))
+            after = cross(subtract(corners[1], corners[0]), subtract(corners[2], corners[0]))
+            lengths = math.sqrt(dot(before, before) * dot(after, after))
+            if lengths <= 1e-30 or dot(before, after) < LOD_FLIP_COSINE * lengths:
+                return True
+
+        return False
+
+    for edge in edge_faces:
+        push(*edge)
+
+    results, error = [], 0.0
+    for target in targets:
+        while live > target and heap:
+            _, keep, remove, keep_version, remove_version, position = heapq.heappop(heap)
+            if version[keep] != keep_version or version[remove] != remove_version:
+                continue
+
+            # Link condition: the ends may only share the vertices of the faces on the edge
+            shared_faces = vertex_faces[keep] & vertex_faces[remove]
+            if len(neighbours(keep) & neighbours(remove)) != len(shared_faces):
+                continue
+            if flips(keep, remove, position) or flips(remove, keep, position):
+                continue
+
+            merged[remove] = keep
+            positions[keep] = position
+            quadrics[keep] = add_quadrics(quadrics[keep], quadrics[remove])
+
+            for f in vertex_faces[remove]:
+                face = faces[f]
+                if f in shared_faces:
+                    alive[f] = False
+                    live -= 1
+                    for u in face:
+                        if u != remove:
+                            vertex_faces[u].discard(f)
+                else:
+                    face[face.index(remove)] = keep
+                    vertex_faces[keep].add(f)
+
+            vertex_faces[remove] = set()
+            version[keep] += 1
+            version[remove] += 1
+
+            for u in neighbours(keep):
+                push(keep, u)
+
+        if live > target:
+            break
+
+        for v, vertex in enumerate(vertices):
+            around = vertex_faces[survivor(v)]
+            if around:
+                error = max(error, min(triangle_distance(vertex, *(positions[u] for u in faces[f])) for f in around))
+
+        results.append(([tuple(face) for f, face in enumerate(faces) if alive[f]], error))
+
+    return positions, results
+
+
+def lod_chain(source, vertices, triangles, levels):
+    """
+    The mesh ordered for the vertex cache followed by up to levels - 1 simplified levels of detail, each as
+    (vertices, triangles, switch radius). The triangle counts fall geometrically towards LOD_MIN_TRIANGLES. A
+    level replaces the previous one once the projected radius of the bounds drops below its switch radius, where
+    its error is LOD_PIXEL_ERROR pixels on the screen.
+    """
+    vertices, triangles = order(source, vertices, triangles)
+    chain = [(vertices, triangles, 0.0)]
+    if levels < 2 or len(triangles) <= LOD_MIN_TRIANGLES:
+        return chain
+
+    count = len(triangles)
+    ratio = min(LOD_REDUCTION, (LOD_MIN_TRIANGLES / count) ** (1.0 / (levels - 1)))
+    targets = []
+    for level in range(1, levels):
+        target = max(LOD_MIN_TRIANGLES, int(count * ratio ** level))
+        if target > (targets[-1] if targets else count) * (1.0 - LOD_MIN_SAVING):
+            break
+        targets.append(target)
+
+    radius = bounding_sphere(vertices)[1]
+    positions, results = simplify(vertices, triangles, targets)
+
+    for level_triangles, error in results:
+        level_triangles = remove_degenerate(positions, level_triangles)
+        if not level_triangles:
+            break
+
+        switch = LOD_PIXEL_ERROR * radius / error if error * LOD_MAX_RADIUS > LOD_PIXEL_ERROR * radius else LOD_MAX_RADIUS
+        chain.append(order(source, positions, level_triangles) + (switch,))
+
+    return chain
+
+
+def c_float(value):
+    text = "%.9g" % value
+    if "e" not in text and "." not in text:
+        text += ".0"
+    return text + "f"
+
+
+def c_vector(vector):
+    return "{.x = %s, .y = %s, .z = %s}" % tuple(c_float(value) for value in vector)
+
+
+def write_mesh(source, output, name, chain, sphere):
+    symbol = re.sub(r"_(\w)", lambda match: match.group(1).upper(), name) + "Mesh"
+    guard = "INC_3D_%s_MESH_H" % name.upper()
+    origin = "Generated by tools/bake_mesh.py from %s, do not edit." % os.path.basename(source)
+
+    with open(os.path.join(output, "%s_mesh.h" % name), "w") as header:
+        header.write("//\n// %s\n//\n\n" % origin)
+        header.write("#ifndef %s\n#define %s\n\n" % (guard, guard))
+        header.write("#include \"renderer/mesh.h\"\n\n")
+        header.write("extern const Mesh %s;\n\n" % symbol)
+        header.write("#endif //%s\n" % guard)
+
+    with open(os.path.join(output, "%s_mesh.c" % name), "w") as code:
+        code.write("//\n// %s\n//\n\n" % origin)
+        code.write("#include \"%s_mesh.h\"\n\n" % name)
+
+        # Coarsest level first, so every level can point at the next coarser one
+        for level in reversed(range(len(chain))):
+            vertices, triangles, _ = chain[level]
+            face_planes = planes(vertices, triangles)
+            suffix = "" if level == 0 else str(level)
+
+            code.write("static const Vector3 vertices%s[%d] = {\n" % (suffix, len(vertices)))
+            code.writelines("        %s,\n" % c_vector(vertex) for vertex in vertices)
+            code.write("};\n\n")
+
+            code.write("static const uint16_t indices%s[%d] = {\n" % (suffix, len(triangles) * 3))
+            code.writelines("        %d, %d, %d,\n" % triangle for triangle in triangles)
+            code.write("};\n\n")
+
+            code.write("static const Vector3 normals%s[%d] = {\n" % (suffix, len(triangles)))
+            code.writelines("        %s,\n" % c_vector(normal) for normal, _ in face_planes)
+            code.write("};\n\n")
+
+            code.write("static const float planeDistances%s[%d] = {\n" % (suffix, len(triangles)))
+            code.writelines("        %s,\n" % c_float(distance) for _, distance in face_planes)
+            code.write("};\n\n")
+
+            code.write("const Mesh %s = {\n" % symbol if level == 0 else "static const Mesh lod%d = {\n" % level)
+            code.write("        .vertexCount = %d,\n" % len(vertices))
+            code.write("        .vertices = vertices%s,\n" % suffix)
+            code.write("        .triangleCount = %d,\n" % len(triangles))
+            code.write("        .indices = indices%s,\n" % suffix)
+            code.write("        .normals = normals%s,\n" % suffix)
+            code.write("        .planeDistances = planeDistances%s,\n" % suffix)
+            code.write("        .bounds = {.center = %s, .radius = %s}" % (c_vector(sphere[0]), c_float(sphere[1])))
+            if level + 1 < len(chain):
+                code.write(",\n        .lod = &lod%d,\n" % (level + 1))
+                code.write("        .lodRadius = %s" % c_float(chain[level + 1][2]))
+            code.write("\n};\n\n" if level > 0 else "\n};\n")
+
+
+def align(offset):
+    return (offset + 3) & ~3
+
+
+def binary_mesh(chain, sphere):
+    """
+    Lays out the header, the table of the coarser levels and the blocks of every level in the order and layout of
+    MeshFileHeader and MeshFileLod, every block aligned to 4 bytes.
+    """
+    header_size = 60
+    lod_offset = header_size
+    offset = lod_offset + 28 * (len(chain) - 1)
+
+    layouts = []
+    for vertices, triangles, _ in chain:
+        vertex_offset = align(offset)
+        index_offset = align(vertex_offset + 12 * len(vertices))
+        normal_offset = align(index_offset + 6 * len(triangles))
+        plane_offset = normal_offset + 12 * len(triangles)
+        offset = plane_offset + 4 * len(triangles)
+        layouts.append((vertex_offset, index_offset, normal_offset, plane_offset))
+
+    file_size = offset
+    data = bytearray(file_size)
+    vertices, triangles, _ = chain[0]
+    struct.pack_into("<4sHHII4f7I", data, 0, MESH_FILE_MAGIC, MESH_FILE_VERSION, header_size,
+                     len(vertices), len(triangles), *sphere[0], sphere[1], *layouts[0],
+                     len(chain) - 1, lod_offset, file_size)
+
+    for level, ((vertices, triangles, switch), layout) in enumerate(zip(chain, layouts)):
+        vertex_offset, index_offset, normal_offset, plane_offset = layout
+        if level > 0:
+            struct.pack_into("<f6I", data, lod_offset + 28 * (level - 1), switch,
+                             len(vertices), len(triangles), *layout)
+
+        for i, vertex in enumerate(vertices):
+            struct.pack_into("<3f", data, vertex_offset + 12 * i, *vertex)
+        for i, triangle in enumerate(triangles):
+            struct.pack_into("<3H", data, index_offset + 6 * i, *triangle)
+        for i, (normal, distance) in enumerate(planes(vertices, triangles)):
+            struct.pack_into("<3f", data, normal_offset + 12 * i, *normal)
+            struct.pack_into("<f", data, plane_offset + 4 * i, distance)
+
+    return data
+
+
+def write_binary(output, name, chain, sphere):
+    with open(os.path.join(output, "%s.mesh" % name), "wb") as file:
+        file.write(binary_mesh(chain, sphere))
+
+
+def write_world(output, name, chunks, sphere):
+    """Writes a WorldFileHeader, the chunk table and the binary mesh of every chunk, as (sphere, data) pairs."""
+    header_size = 36
+    table_offset = header_size
+    offset = align(table_offset + 24 * len(chunks))
+
+    table = bytearray()
+    for chunk_sphere, data in chunks:
+        table += struct.pack("<4fII", *chunk_sphere[0], chunk_sphere[1], offset, len(data))
+        offset = align(offset + len(data))
+
+    data = bytearray(offset)
+    struct.pack_into("<4sHHI4fII", data, 0, WORLD_FILE_MAGIC, WORLD_FILE_VERSION, header_size,
+                     len(chunks), *sphere[0], sphere[1], table_offset, offset)
+    data[table_offset:table_offset + len(table)] = table
+
+    for i, (_, chunk) in enumerate(chunks):
+        chunk_offset = struct.unpack_from("<I", table, 24 * i + 16)[0]
+        data[chunk_offset:chunk_offset + len(chunk)] = chunk
+
+    with open(os.path.join(output, "%s.world" % name), "wb") as file:
+        file.write(data)
+
+
+def split_chunks(vertices, triangles, size):
+    """Groups the triangles by the cube of the grid their centroid falls into."""
+    cells = {}
+
+    for triangle in triangles:
+        centroid = [sum(vertices[index][axis] for index in triangle) / 3.0 for axis in range(3)]
+        cell = tuple(math.floor(value / size) for value in centroid)
+        cells.setdefault(cell, []).append(triangle)
+
+    return [cells[cell] for cell in sorted(cells)]
+
+
+def order(source, vertices, triangles):
+    """Orders the triangles for the vertex cache and keeps only the vertices they use, in the order they use them."""
+    vertices, triangles = renumber(vertices, triangles)
+    triangles = optimize_cache(len(vertices), triangles)
+    vertices, triangles = renumber(vertices, triangles)
+    if len(vertices) > 65535:
+        fail("%s: %d vertices do not fit 16-bit indices" % (source, len(vertices)))
+
+    return vertices, triangles
+
+
+def main():
+    arguments = sys.argv[1:]
+    binary = "--binary" in arguments
+    if binary:
+        arguments.remove("--binary")
+
+    chunk_size = None
+    if "--chunks" in arguments:
+        position = arguments.index("--chunks")
+        try:
+            chunk_size = float(arguments[position + 1])
+        except (IndexError, ValueError):
+            chunk_size = 0.0
+        del arguments[position:position + 2]
+
+    levels = LOD_LEVELS
+    if "--lods" in arguments:
+        position = arguments.index("--lods")
+        try:
+            levels = int(arguments[position + 1])
+        except (IndexError, ValueError):
+            levels = 0
+        del arguments[position:position + 2]
+
+    if len(arguments) != 2 or (binary and chunk_size is not None) or (chunk_size is not None and chunk_size <= 0.0) or \
+            not 1 <= levels <= LOD_LEVELS:
+        fail("usage: bake_mesh.py [--binary | --chunks <size>] [--lods <1-%d>] <input.obj|input.ply> <output directory>"
+             % LOD_LEVELS)
+
+    source, output = arguments
+    name, extension = os.path.splitext(os.path.basename(source))
+
+    if extension.lower() == ".obj":
+        vertices, triangles = read_obj(source)
+    elif extension.lower() == ".ply":
+        vertices, triangles = read_ply(source)
+    else:
+        fail("%s: unknown mesh format %s" % (source, extension))
+
+    for triangle in triangles:
+        if any(index < 0 or index >= len(vertices) for index in triangle):
+            fail("%s: vertex index out of range" % source)
+
+    vertices, triangles = weld(vertices, triangles)
+    triangles = remove_degenerate(vertices, triangles)
+    if not triangles:
+        fail("%s: no triangles left" % source)
+
+    os.makedirs(output, exist_ok=True)
+    name = re.sub(r"\W", "_", name.lower())
+
+    if chunk_size is not None:
+        # Chunks are ordered and indexed on their own, so only a chunk has to fit 16-bit indices
+        chunks = []
+        for chunk_triangles in split_chunks(vertices, triangles, chunk_size):
+            chain = lod_chain(source, vertices, chunk_triangles, levels)
+            chunk_sphere = bounding_sphere(chain[0][0])
+            chunks.append((chunk_sphere, binary_mesh(chain, chunk_sphere)))
+
+        used = sorted({index for triangle in triangles for index in triangle})
+        write_world(output, name, chunks, bounding_sphere([vertices[index] for index in used]))
+        return
+
+    chain = lod_chain(source, vertices, triangles, levels)
+    sphere = bounding_sphere(chain[0][0])
+
+    if binary:
+        write_binary(output, name, chain, sphere)
+    else:
+        write_mesh(source, output, name, chain, sphere)
+
+
+if __name__ == "__main__":
+    main()